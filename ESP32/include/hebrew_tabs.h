@@ -2,6 +2,7 @@
 #define HEBREW_TABS_H
 
 #include <lvgl.h>
+#include "lv_expandable_card.h"
 
 void create_welcome_tab(lv_obj_t *tab);
 void create_pull_refresh_tab(lv_obj_t *tab);
@@ -9,6 +10,9 @@ void create_niqqud_demo_tab(lv_obj_t *tab);
 void create_news_tab(lv_obj_t *tab);
 void create_gallery_tab(lv_obj_t *tab);
 
+// Append a card to the news tab (NULL before the tab exists); card_data must outlive the card
+lv_obj_t* news_tab_add_card(const lv_card_data_t *card_data);
+
 // Tabview creation function
 lv_obj_t* create_hebrew_tabview(lv_obj_t *parent);
 
@@ -2,11 +2,35 @@
 #define LV_CONF_H
 
 #define LV_USE_DEV_VERSION 1
+// 16 = RGB565 (LovyanGFX or the LUT pipeline expands to RGB666 for the panel)
+// 24 = render in the panel's depth, see LVGL_PIXEL_PIPELINE in pixel_convert.hpp
+#ifndef LV_COLOR_DEPTH
 #define LV_COLOR_DEPTH 16
+#endif
 //#define LV_MEM_SIZE (128 * 1024U)
 
 #define LV_COLOR_16_SWAP 0
 
+/* OS layer: lets LVGL render with several software draw units in parallel.
+ * The device uses FreeRTOS, the native build pthreads. */
+#ifndef LV_USE_OS
+#ifdef NATIVE_BUILD
+#define LV_USE_OS LV_OS_PTHREAD
+#else
+#define LV_USE_OS LV_OS_FREERTOS
+#endif
+#endif
+
+/* Draw threads, one per core; -D LV_DRAW_SW_DRAW_UNIT_CNT=1 for the single-unit build */
+#ifndef LV_DRAW_SW_DRAW_UNIT_CNT
+#define LV_DRAW_SW_DRAW_UNIT_CNT 2
+#endif
+
+/* Below the touch sampler (3), so touch reads are never held up by rendering */
+#ifndef LV_DRAW_THREAD_PRIO
+#define LV_DRAW_THREAD_PRIO LV_THREAD_PRIO_MID
+#endif
+
 
 /* Disable TFT_eSPI driver - using LovyanGFX instead */
 #define LV_USE_TFT_ESPI 0
@@ -0,0 +1,115 @@
+#ifndef UI_COMMAND_H
+#define UI_COMMAND_H
+
+#include <lvgl.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * UI command queue for background tasks
+ *
+ * LVGL may only be called from the LVGL task (loop()). Sensor, network and
+ * storage tasks post UI changes here instead; the post functions can be
+ * called from any task (not from an ISR), never block and copy the strings
+ * they are given. Each post wakes the LVGL task (LVGL_TASK_WAKE_APP), which
+ * applies the queue with ui_command_drain() before lv_timer_handler().
+ *
+ * Text updates do not take queue entries: each label gets one of
+ * UI_CMD_TEXT_SLOTS latest-text slots, and a post replaces the text still
+ * waiting there, so however fast a producer posts, the LVGL task only sets
+ * the newest text. A slot stays with its label; texts for more labels
+ * than that go through the queue and are coalesced within one drain.
+ *
+ * A drain applies every pending slot text and at most UI_CMD_BUDGET queued
+ * commands, so a chatty producer cannot stall a frame. When the queue is
+ * full a post returns false and the command is dropped; the last
+ * UI_CMD_RESERVED entries are kept for ui_command_pull_refresh_done() and
+ * ui_command_call(), so cards and texts cannot crowd them out.
+ *
+ * Targets are checked with lv_obj_is_valid() before use, so a command for
+ * an object deleted in the meantime is discarded.
+ */
+
+// Queue entries (power of two)
+#ifndef UI_CMD_QUEUE_SIZE
+#define UI_CMD_QUEUE_SIZE 64
+#endif
+
+// Commands taken from the queue per drain (coalesced ones included)
+#ifndef UI_CMD_BUDGET
+#define UI_CMD_BUDGET 16
+#endif
+
+// Labels with their own latest-text slot
+#ifndef UI_CMD_TEXT_SLOTS
+#define UI_CMD_TEXT_SLOTS 8
+#endif
+
+// Queue entries only the end of a refresh and calls may take
+#ifndef UI_CMD_RESERVED
+#define UI_CMD_RESERVED 8
+#endif
+
+typedef void (*ui_command_fn_t)(lv_obj_t *target, void *arg);
+
+typedef struct {
+    uint32_t posted;
+    uint32_t dropped;           // Posts that found the queue full (or no memory for the text)
+    uint32_t applied;
+    uint32_t coalesced;         // Text updates replaced by a newer one before they were applied
+    uint32_t stale;             // Commands for deleted objects
+    uint32_t budget_hits;       // Drains that left commands for the next one
+    uint32_t latency_avg_us;    // Post to apply
+    uint32_t latency_max_us;
+} ui_command_stats_t;
+
+/**
+ * @brief Set a label's text (lv_label_set_text)
+ *
+ * @param label Label to change
+ * @param text Text, copied
+ * @return true if queued
+ */
+bool ui_command_set_text(lv_obj_t *label, const char *text);
+
+/**
+ * @brief End a pull-to-refresh (lv_pull_refresh_complete)
+ *
+ * @param container Pull-to-refresh container
+ * @return true if queued
+ */
+bool ui_command_pull_refresh_done(lv_obj_t *container);
+
+/**
+ * @brief Append an article card to the news tab
+ *
+ * @param title Card title, copied
+ * @param content Card content, copied
+ * @return true if queued
+ */
+bool ui_command_add_card(const char *title, const char *content);
+
+/**
+ * @brief Run fn(target, arg) in the LVGL task
+ *
+ * For changes the other commands do not cover. arg must stay valid until
+ * fn has run. A NULL target is passed through without the validity check.
+ *
+ * @return true if queued
+ */
+bool ui_command_call(ui_command_fn_t fn, lv_obj_t *target, void *arg);
+
+/**
+ * @brief Apply queued commands (LVGL task, before lv_timer_handler())
+ *
+ * @return Number of commands applied
+ */
+uint32_t ui_command_drain(void);
+
+void ui_command_get_stats(ui_command_stats_t *stats);
+void ui_command_reset_stats(void);
+
+// Log the stats since the last call and reset them (a perf_metrics report)
+void ui_command_report_stats(void);
+
+#endif // UI_COMMAND_H
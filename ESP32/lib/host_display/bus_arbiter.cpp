@@ -0,0 +1,69 @@
+#include "bus_arbiter.hpp"
+#include "esp_log.h"
+#include <chrono>
+#include <string.h>
+
+/**
+ * Host version of the bus arbiter
+ *
+ * The native build runs on one thread, so no client ever waits and no slot
+ * is ever handed out. Hold times use the host clock: the simulated esp_timer
+ * does not move inside lv_timer_handler().
+ */
+
+static const char* TAG = "BUS";
+
+static bus_client_stats_t stats[BUS_CLIENT_COUNT];
+static int holder = -1;
+static uint32_t depth = 0;
+static std::chrono::steady_clock::time_point hold_start;
+
+void bus_arbiter_init() {
+    bus_arbiter_reset_stats();
+    ESP_LOGI(TAG, "Bus arbiter ready (single-threaded host)");
+}
+
+bool bus_arbiter_acquire(bus_client_t client, uint32_t timeout_ms) {
+    (void)timeout_ms;
+    if (depth++ == 0) {
+        holder = client;
+        hold_start = std::chrono::steady_clock::now();
+        stats[client].transactions++;
+    }
+    return true;
+}
+
+void bus_arbiter_release(bus_client_t client) {
+    (void)client;
+    if (depth == 0 || --depth > 0) return;
+
+    stats[holder].busy_us += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - hold_start).count();
+    holder = -1;
+}
+
+bool bus_arbiter_yield(bus_client_t holder_client) {
+    (void)holder_client;
+    return false;
+}
+
+bool bus_arbiter_contended(bus_client_t holder_client) {
+    (void)holder_client;
+    return false;
+}
+
+const char* bus_arbiter_client_name(bus_client_t client) {
+    switch (client) {
+        case BUS_CLIENT_DISPLAY: return "display";
+        case BUS_CLIENT_TOUCH: return "touch";
+        default: return "?";
+    }
+}
+
+void bus_arbiter_get_stats(bus_client_t client, bus_client_stats_t *out) {
+    if (out && client < BUS_CLIENT_COUNT) *out = stats[client];
+}
+
+void bus_arbiter_reset_stats() {
+    memset(stats, 0, sizeof(stats));
+}
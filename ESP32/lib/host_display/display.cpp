@@ -0,0 +1,261 @@
+#include "display.hpp"
+#include "bus_arbiter.hpp"
+#include "esp_log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+static const char* TAG = "TFT";
+
+// Global LovyanGFX stand-in
+LGFX gfx;
+
+LGFX::LGFX(void)
+    : _framebuffer(NULL), _width(TFT_HOR_RES), _height(TFT_VER_RES),
+      _rotation(0), _brightness(0), _asleep(false),
+      _win_x(0), _win_y(0), _win_w(0), _win_h(0), _cur_x(0), _cur_y(0),
+      _write_depth(0), _touch_pressed(false), _touch_x(0), _touch_y(0),
+      _bus_hz(0), _dma_done_at() {
+    resetHostBusStats();
+}
+
+LGFX::~LGFX(void) {
+    free(_framebuffer);
+}
+
+bool LGFX::init(void) {
+    if (!_framebuffer) {
+        _framebuffer = (uint16_t*)calloc((size_t)TFT_HOR_RES * TFT_VER_RES, sizeof(uint16_t));
+    }
+    return _framebuffer != NULL;
+}
+
+void LGFX::setRotation(uint8_t rotation) {
+    _rotation = rotation & 3;
+    bool landscape = _rotation & 1;
+    _width = landscape ? TFT_VER_RES : TFT_HOR_RES;
+    _height = landscape ? TFT_HOR_RES : TFT_VER_RES;
+}
+
+void LGFX::fillScreen(uint16_t color) {
+    startWrite();
+    setAddrWindow(0, 0, _width, _height);
+    for (int32_t i = 0; i < _width * _height; i++) {
+        write_pixel(color);
+    }
+    _stats.pixel_bytes += (uint64_t)_width * _height * HOST_WIRE_BYTES_PER_PIXEL;
+    bus_transfer((uint64_t)_width * _height * HOST_WIRE_BYTES_PER_PIXEL, false);
+    endWrite();
+}
+
+// SLPIN / SLPOUT: one command byte each; the framebuffer is kept, like the ILI9488's memory
+void LGFX::sleep(void) {
+    _asleep = true;
+    _stats.command_bytes += 1;
+}
+
+void LGFX::wakeup(void) {
+    _asleep = false;
+    _stats.command_bytes += 1;
+}
+
+void LGFX::startWrite(void) {
+    if (_write_depth++ == 0) {
+        _stats.transactions++;
+    }
+}
+
+void LGFX::endWrite(void) {
+    if (_write_depth > 0 && --_write_depth == 0) {
+        waitDMA();  // Closing the transaction waits for the bus, as on the device
+    }
+}
+
+void LGFX::bus_transfer(uint64_t bytes, bool use_dma) {
+    // Every bus operation queues behind a transfer that is still on the wire
+    waitDMA();
+    if (_bus_hz == 0) return;
+
+    uint64_t wire_us = bytes * 8 * 1000000ULL / _bus_hz;
+    _stats.bus_busy_us += wire_us;
+    _dma_done_at = std::chrono::steady_clock::now() + std::chrono::microseconds(wire_us);
+    if (!use_dma) {
+        waitDMA();
+    }
+}
+
+void LGFX::waitDMA(void) {
+    if (dmaBusy()) {
+        std::this_thread::sleep_until(_dma_done_at);
+    }
+}
+
+bool LGFX::dmaBusy(void) const {
+    return std::chrono::steady_clock::now() < _dma_done_at;
+}
+
+void LGFX::setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) {
+    _win_x = x;
+    _win_y = y;
+    _win_w = w;
+    _win_h = h;
+    _cur_x = x;
+    _cur_y = y;
+    _stats.windows++;
+    _stats.command_bytes += HOST_ADDR_WINDOW_BYTES;
+    bus_transfer(HOST_ADDR_WINDOW_BYTES, false);
+}
+
+void LGFX::write_pixel(uint16_t color) {
+    if (_framebuffer && _cur_x >= 0 && _cur_x < _width && _cur_y >= 0 && _cur_y < _height) {
+        _framebuffer[_cur_y * _width + _cur_x] = color;
+    }
+    if (++_cur_x >= _win_x + _win_w) {
+        _cur_x = _win_x;
+        if (++_cur_y >= _win_y + _win_h) {
+            _cur_y = _win_y;  // Panel wraps back to the window origin
+        }
+    }
+}
+
+// LovyanGFX expands RGB565 input to the panel's 3-byte format on the CPU
+// before it reaches the bus. Doing the same work here keeps the cost of
+// that path comparable with pre-converted input (pixel_convert.hpp).
+static uint8_t convert_scratch[1024 * 3];
+
+static void expand_rgb565(const lgfx::rgb565_t* data, int32_t len) {
+    while (len > 0) {
+        int32_t n = len < 1024 ? len : 1024;
+        uint8_t* dst = convert_scratch;
+        for (int32_t i = 0; i < n; i++) {
+            uint16_t p = data[i].raw;
+            dst[0] = (uint8_t)(((p >> 8) & 0xF8) | (p >> 13));
+            dst[1] = (uint8_t)(((p >> 3) & 0xFC) | ((p >> 9) & 0x03));
+            dst[2] = (uint8_t)((p << 3) | ((p >> 2) & 0x07));
+            dst += 3;
+        }
+        data += n;
+        len -= n;
+    }
+}
+
+void LGFX::writePixels(const lgfx::rgb565_t* data, int32_t len) {
+    expand_rgb565(data, len);
+    for (int32_t i = 0; i < len; i++) {
+        write_pixel(data[i].raw);
+    }
+    _stats.pixel_bytes += (uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL;
+    bus_transfer((uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL, false);
+}
+
+void LGFX::writePixelsDMA(const lgfx::rgb565_t* data, int32_t len) {
+    expand_rgb565(data, len);
+    // The framebuffer is updated immediately; only the wire time is deferred
+    for (int32_t i = 0; i < len; i++) {
+        write_pixel(data[i].raw);
+    }
+    _stats.pixel_bytes += (uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL;
+    bus_transfer((uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL, true);
+}
+
+static inline uint16_t to_rgb565(uint8_t r, uint8_t g, uint8_t b) {
+    return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
+
+void LGFX::writePixels(const lgfx::rgb888_t* data, int32_t len) {
+    for (int32_t i = 0; i < len; i++) {
+        write_pixel(to_rgb565(data[i].r, data[i].g, data[i].b));
+    }
+    _stats.pixel_bytes += (uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL;
+    bus_transfer((uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL, false);
+}
+
+void LGFX::writePixelsDMA(const lgfx::rgb888_t* data, int32_t len) {
+    for (int32_t i = 0; i < len; i++) {
+        write_pixel(to_rgb565(data[i].r, data[i].g, data[i].b));
+    }
+    _stats.pixel_bytes += (uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL;
+    bus_transfer((uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL, true);
+}
+
+void LGFX::writePixels(const lgfx::bgr888_t* data, int32_t len) {
+    for (int32_t i = 0; i < len; i++) {
+        write_pixel(to_rgb565(data[i].r, data[i].g, data[i].b));
+    }
+    _stats.pixel_bytes += (uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL;
+    bus_transfer((uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL, false);
+}
+
+void LGFX::writePixelsDMA(const lgfx::bgr888_t* data, int32_t len) {
+    for (int32_t i = 0; i < len; i++) {
+        write_pixel(to_rgb565(data[i].r, data[i].g, data[i].b));
+    }
+    _stats.pixel_bytes += (uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL;
+    bus_transfer((uint64_t)len * HOST_WIRE_BYTES_PER_PIXEL, true);
+}
+
+void LGFX::writeWireBytesDMA(const uint8_t* data, uint32_t len) {
+    for (uint32_t i = 0; i + 2 < len; i += 3) {
+        write_pixel(to_rgb565(data[i], data[i + 1], data[i + 2]));
+    }
+    _stats.pixel_bytes += len;
+    bus_transfer(len, true);
+}
+
+void LGFX::writeFillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color) {
+    setAddrWindow(x, y, w, h);
+    for (int32_t i = 0; i < w * h; i++) {
+        write_pixel(color);
+    }
+    _stats.fill_pixels += (uint64_t)w * h;
+    _stats.pixel_bytes += (uint64_t)w * h * HOST_WIRE_BYTES_PER_PIXEL;
+    bus_transfer((uint64_t)w * h * HOST_WIRE_BYTES_PER_PIXEL, false);
+}
+
+void LGFX::writeFillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    writeFillRect(x, y, w, h, to_rgb565(color >> 16, color >> 8, color));
+}
+
+void LGFX::writeFastHLine(int32_t x, int32_t y, int32_t w, uint16_t color) {
+    writeFillRect(x, y, w, 1, color);
+}
+
+void LGFX::writeFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+    writeFillRect(x, y, w, 1, color);
+}
+
+bool LGFX::getTouch(uint16_t* x, uint16_t* y) {
+    if (!_touch_pressed) return false;
+    if (x) *x = (uint16_t)_touch_x;
+    if (y) *y = (uint16_t)_touch_y;
+    return true;
+}
+
+void LGFX::setHostTouch(bool pressed, int32_t x, int32_t y) {
+    _touch_pressed = pressed;
+    _touch_x = x;
+    _touch_y = y;
+}
+
+void LGFX::resetHostBusStats(void) {
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+void init_display() {
+    ESP_LOGI(TAG, "Initializing host framebuffer display...");
+    gfx.init();
+    bus_arbiter_init();
+    gfx.setRotation(TFT_ROTATION);
+    gfx.setBrightness(255);
+    gfx.fillScreen(0x0000);
+    gfx.resetHostBusStats();
+    ESP_LOGI(TAG, "Host display initialized");
+}
+
+void touch_calibrate() {
+    // Scripted touch points are already in screen coordinates
+}
+
+void init_touch() {
+    touch_calibrate();
+}
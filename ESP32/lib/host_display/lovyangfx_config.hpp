@@ -0,0 +1,118 @@
+#ifndef LOVYANGFX_CONFIG_HPP
+#define LOVYANGFX_CONFIG_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include <chrono>
+
+/**
+ * Host stand-in for the LovyanGFX ILI9488 device
+ *
+ * Implements the subset of the LGFX API the firmware uses and renders into
+ * an in-memory RGB565 framebuffer. Every bus operation is accounted as the
+ * bytes an ILI9488 on 4-wire SPI would receive (18-bit pixels = 3 bytes).
+ *
+ * With setHostBusFrequency() the stand-in also simulates wire time: blocking
+ * writes sleep for their transfer, DMA writes return at once and complete in
+ * the background, so render/transfer overlap can be measured off-device.
+ */
+namespace lgfx {
+    struct rgb565_t {
+        uint16_t raw;
+    };
+    // Same memory layouts as LovyanGFX: rgb888_t is B,G,R (LVGL 24-bit), bgr888_t is R,G,B (ILI9488 wire order)
+    struct __attribute__((packed)) rgb888_t {
+        uint8_t b, g, r;
+    };
+    struct __attribute__((packed)) bgr888_t {
+        uint8_t r, g, b;
+    };
+}
+
+// Bytes of CASET + PASET + RAMWR for one address window on the ILI9488
+#define HOST_ADDR_WINDOW_BYTES 11
+// Bytes per pixel on the wire (ILI9488 SPI only accepts 18-bit color)
+#define HOST_WIRE_BYTES_PER_PIXEL 3
+
+typedef struct {
+    uint64_t bus_busy_us;      // Simulated wire time of all transfers
+    uint64_t pixel_bytes;      // Pixel payload bytes (fills included: the ILI9488 has no fill command)
+    uint64_t fill_pixels;      // Pixels sent by writeFillRect/writeFastHLine (no buffer read or conversion)
+    uint64_t command_bytes;    // Address window / command overhead bytes
+    uint32_t transactions;     // startWrite/endWrite pairs
+    uint32_t windows;          // setAddrWindow calls
+} host_bus_stats_t;
+
+class LGFX
+{
+  uint16_t* _framebuffer;
+  int32_t _width;
+  int32_t _height;
+  uint8_t _rotation;
+  uint8_t _brightness;
+  bool _asleep;
+
+  // Current address window and write cursor
+  int32_t _win_x, _win_y, _win_w, _win_h;
+  int32_t _cur_x, _cur_y;
+  uint32_t _write_depth;
+
+  // Scripted touch state
+  bool _touch_pressed;
+  int32_t _touch_x, _touch_y;
+
+  host_bus_stats_t _stats;
+
+  // Simulated wire time
+  uint32_t _bus_hz;
+  std::chrono::steady_clock::time_point _dma_done_at;
+
+  void write_pixel(uint16_t color);
+  void bus_transfer(uint64_t bytes, bool use_dma);
+
+public:
+  LGFX(void);
+  ~LGFX(void);
+
+  bool init(void);
+  void setRotation(uint8_t rotation);
+  uint8_t getRotation(void) const { return _rotation; }
+  int32_t width(void) const { return _width; }
+  int32_t height(void) const { return _height; }
+  void setBrightness(uint8_t brightness) { _brightness = brightness; }
+  uint8_t getBrightness(void) const { return _brightness; }
+  void fillScreen(uint16_t color);
+  void sleep(void);
+  void wakeup(void);
+
+  void startWrite(void);
+  void endWrite(void);
+  void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h);
+  void writePixels(const lgfx::rgb565_t* data, int32_t len);
+  void writePixelsDMA(const lgfx::rgb565_t* data, int32_t len);
+  void writePixels(const lgfx::rgb888_t* data, int32_t len);
+  void writePixelsDMA(const lgfx::rgb888_t* data, int32_t len);
+  void writePixels(const lgfx::bgr888_t* data, int32_t len);
+  void writePixelsDMA(const lgfx::bgr888_t* data, int32_t len);
+  void writeWireBytesDMA(const uint8_t* data, uint32_t len);  // R,G,B per pixel
+  void writeFillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color);
+  void writeFillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);  // 0xRRGGBB
+  void writeFastHLine(int32_t x, int32_t y, int32_t w, uint16_t color);
+  void writeFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+  void waitDMA(void);
+  bool dmaBusy(void) const;
+
+  bool getTouch(uint16_t* x, uint16_t* y);
+
+  // Host-only helpers
+  void setHostTouch(bool pressed, int32_t x, int32_t y);
+  bool getHostPenDown(void) const { return _touch_pressed; }  // XPT2046 PENIRQ level, inverted
+  bool getHostAsleep(void) const { return _asleep; }  // Panel in sleep mode (SLPIN)
+  const uint16_t* getHostFramebuffer(void) const { return _framebuffer; }
+  const host_bus_stats_t& getHostBusStats(void) const { return _stats; }
+  void resetHostBusStats(void);
+  void setHostBusFrequency(uint32_t hz) { _bus_hz = hz; }  // 0 = transfers are instant
+  std::chrono::steady_clock::time_point getHostDmaDoneAt(void) const { return _dma_done_at; }
+};
+
+#endif // LOVYANGFX_CONFIG_HPP
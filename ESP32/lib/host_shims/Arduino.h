@@ -0,0 +1,27 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino core functions used by the UI code
+ *
+ * millis()/micros() follow the simulated esp_timer clock.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_timer.h"
+
+static inline unsigned long millis(void) {
+    return (unsigned long)(esp_timer_get_time() / 1000);
+}
+
+static inline unsigned long micros(void) {
+    return (unsigned long)esp_timer_get_time();
+}
+
+static inline void delay(uint32_t ms) {
+    esp_timer_host_advance((uint64_t)ms * 1000);
+}
+
+#endif // HOST_ARDUINO_H
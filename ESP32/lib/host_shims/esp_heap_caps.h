@@ -0,0 +1,56 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief Host stand-in for the ESP-IDF capability-aware heap
+ *
+ * All capabilities map onto the process heap. The probe functions report
+ * a fixed internal-RAM budget resembling an ESP32 after boot, so code that
+ * sizes itself from them picks the same configuration as on the device.
+ */
+
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define MALLOC_CAP_EXEC     (1 << 0)
+#define MALLOC_CAP_32BIT    (1 << 1)
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_DEFAULT  (1 << 12)
+
+#ifndef HOST_HEAP_FREE_BYTES
+#define HOST_HEAP_FREE_BYTES (180 * 1024)
+#endif
+#ifndef HOST_HEAP_LARGEST_BLOCK
+#define HOST_HEAP_LARGEST_BLOCK (110 * 1024)
+#endif
+
+static inline void* heap_caps_malloc(size_t size, uint32_t caps) {
+    (void)caps;
+    return malloc(size);
+}
+
+static inline void* heap_caps_realloc(void* ptr, size_t size, uint32_t caps) {
+    (void)caps;
+    return realloc(ptr, size);
+}
+
+static inline void heap_caps_free(void* ptr) {
+    free(ptr);
+}
+
+static inline size_t heap_caps_get_free_size(uint32_t caps) {
+    (void)caps;
+    return HOST_HEAP_FREE_BYTES;
+}
+
+static inline size_t heap_caps_get_largest_free_block(uint32_t caps) {
+    (void)caps;
+    return HOST_HEAP_LARGEST_BLOCK;
+}
+
+#endif // HOST_ESP_HEAP_CAPS_H
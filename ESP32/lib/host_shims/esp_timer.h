@@ -0,0 +1,48 @@
+/**
+ * @file esp_timer.h
+ * @brief Host stand-in for esp_timer driven by a simulated clock
+ *
+ * Time only moves when the host runner calls esp_timer_host_advance(), which
+ * fires any timers that became due. This keeps benchmark runs
+ * deterministic regardless of how fast the host renders.
+ */
+
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*esp_timer_cb_t)(void* arg);
+typedef struct host_esp_timer* esp_timer_handle_t;
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void* arg;
+    int dispatch_method;
+    const char* name;
+    bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+/** Simulated microseconds since boot */
+int64_t esp_timer_get_time(void);
+
+/** Host only: advance the simulated clock and fire due timers */
+void esp_timer_host_advance(uint64_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_ESP_TIMER_H
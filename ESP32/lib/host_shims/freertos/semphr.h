@@ -0,0 +1,56 @@
+/**
+ * @file semphr.h
+ * @brief Host stand-in for FreeRTOS mutexes and binary semaphores
+ *
+ * With a single thread a mutex can never be contended, so take always
+ * succeeds; only the recursion depth is tracked to catch unbalanced gives.
+ * A binary semaphore is a flag: taking an empty one fails at once, since
+ * nothing else could ever give it while the caller waits.
+ */
+
+#ifndef HOST_FREERTOS_SEMPHR_H
+#define HOST_FREERTOS_SEMPHR_H
+
+#include "FreeRTOS.h"
+#include <stdlib.h>
+
+struct host_semaphore {
+    UBaseType_t depth;         // Recursive mutex: nesting level; binary semaphore: 0 or 1
+};
+typedef struct host_semaphore* SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void) {
+    return (SemaphoreHandle_t)calloc(1, sizeof(struct host_semaphore));
+}
+
+static inline BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks) {
+    (void)ticks;
+    if (!sem) return pdFALSE;
+    sem->depth++;
+    return pdTRUE;
+}
+
+static inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem) {
+    if (!sem || sem->depth == 0) return pdFALSE;
+    sem->depth--;
+    return pdTRUE;
+}
+
+static inline SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return (SemaphoreHandle_t)calloc(1, sizeof(struct host_semaphore));
+}
+
+static inline BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    (void)ticks;
+    if (!sem || sem->depth == 0) return pdFALSE;
+    sem->depth = 0;
+    return pdTRUE;
+}
+
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    if (!sem || sem->depth != 0) return pdFALSE;
+    sem->depth = 1;
+    return pdTRUE;
+}
+
+#endif // HOST_FREERTOS_SEMPHR_H
@@ -0,0 +1,125 @@
+/**
+ * @file host_platform.cpp
+ * @brief Host implementations of the ESP-IDF logging and timer stand-ins
+ */
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Logging
+// ---------------------------------------------------------------------------
+
+static esp_log_level_t g_log_level = ESP_LOG_WARN;
+
+void esp_log_level_set(const char* tag, esp_log_level_t level) {
+    (void)tag;  // Per-tag levels are not needed on the host
+    g_log_level = level;
+}
+
+void esp_log_write(esp_log_level_t level, const char* tag, const char* format, ...) {
+    if (level > g_log_level) return;
+
+    static const char level_chars[] = {'N', 'E', 'W', 'I', 'D', 'V'};
+    fprintf(stderr, "%c (%lld) %s: ", level_chars[level],
+            (long long)(esp_timer_get_time() / 1000), tag);
+
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+// ---------------------------------------------------------------------------
+// Simulated esp_timer
+// ---------------------------------------------------------------------------
+
+struct host_esp_timer {
+    esp_timer_cb_t callback;
+    void* arg;
+    uint64_t period_us;
+    uint64_t next_fire_us;
+    bool running;
+};
+
+static uint64_t g_now_us = 0;
+static std::vector<host_esp_timer*> g_timers;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle) {
+    if (!create_args || !create_args->callback || !out_handle) return ESP_FAIL;
+
+    host_esp_timer* timer = new host_esp_timer();
+    timer->callback = create_args->callback;
+    timer->arg = create_args->arg;
+    timer->period_us = 0;
+    timer->next_fire_us = 0;
+    timer->running = false;
+    g_timers.push_back(timer);
+
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    if (!timer || timer->running) return ESP_FAIL;
+    timer->period_us = 0;
+    timer->next_fire_us = g_now_us + timeout_us;
+    timer->running = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us) {
+    if (!timer || period_us == 0) return ESP_FAIL;
+    timer->period_us = period_us;
+    timer->next_fire_us = g_now_us + period_us;
+    timer->running = true;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (!timer || !timer->running) return ESP_FAIL;
+    timer->running = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    for (size_t i = 0; i < g_timers.size(); i++) {
+        if (g_timers[i] == timer) {
+            g_timers.erase(g_timers.begin() + i);
+            delete timer;
+            return ESP_OK;
+        }
+    }
+    return ESP_FAIL;
+}
+
+int64_t esp_timer_get_time(void) {
+    return (int64_t)g_now_us;
+}
+
+void esp_timer_host_advance(uint64_t us) {
+    uint64_t target_us = g_now_us + us;
+
+    // Fire due timers in time order so callbacks observe a consistent clock
+    while (true) {
+        host_esp_timer* next = NULL;
+        for (host_esp_timer* timer : g_timers) {
+            if (timer->running && timer->next_fire_us <= target_us &&
+                (!next || timer->next_fire_us < next->next_fire_us)) {
+                next = timer;
+            }
+        }
+        if (!next) break;
+
+        g_now_us = next->next_fire_us;
+        next->next_fire_us += next->period_us;
+        if (next->period_us == 0) next->running = false;  // One-shot
+        next->callback(next->arg);
+    }
+
+    g_now_us = target_us;
+}
@@ -0,0 +1,155 @@
+#include "bus_arbiter.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <atomic>
+#include <string.h>
+
+static const char* TAG = "BUS";
+
+static SemaphoreHandle_t bus_mutex = NULL;   // Recursive: the holder may nest
+static SemaphoreHandle_t slot_done = NULL;   // Given when a yielded slot is returned
+static std::atomic<uint32_t> waiting[BUS_CLIENT_COUNT];
+static bus_client_stats_t stats[BUS_CLIENT_COUNT];
+
+// Current hold, only touched by the task owning bus_mutex
+static int holder = -1;
+static uint32_t depth = 0;
+static int64_t hold_start_us = 0;
+static uint32_t hold_yields = 0;
+static bool hold_in_slot = false;
+
+// Set by the holder before it yields, consumed by the next client that gets the bus
+static std::atomic<bool> slot_open{false};
+
+static TickType_t to_ticks(uint32_t timeout_ms) {
+    return timeout_ms == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+}
+
+static bool take(bus_client_t client, TickType_t ticks) {
+    int64_t start = esp_timer_get_time();
+    waiting[client]++;
+    bool ok = xSemaphoreTakeRecursive(bus_mutex, ticks) == pdTRUE;
+    waiting[client]--;
+
+    uint32_t waited = (uint32_t)(esp_timer_get_time() - start);
+    stats[client].wait_us += waited;
+    if (waited > stats[client].max_wait_us) stats[client].max_wait_us = waited;
+    return ok;
+}
+
+static void begin_hold(bus_client_t client) {
+    holder = client;
+    hold_start_us = esp_timer_get_time();
+    hold_yields = 0;
+    hold_in_slot = slot_open.exchange(false);
+    if (hold_in_slot) stats[client].yields++;
+}
+
+static void end_hold() {
+    stats[holder].busy_us += esp_timer_get_time() - hold_start_us;
+    holder = -1;
+}
+
+static bool others_waiting(bus_client_t client) {
+    for (int c = 0; c < BUS_CLIENT_COUNT; c++) {
+        if (c != client && waiting[c].load() > 0) return true;
+    }
+    return false;
+}
+
+// Give up the (no longer held) mutex and wait for a waiter to use it and come back
+static bool lend_slot() {
+    xSemaphoreTake(slot_done, 0);  // Drop a stale signal from a slot that timed out
+    slot_open = true;
+    xSemaphoreGiveRecursive(bus_mutex);
+
+    // The waiter runs on its own schedule; without this the holder would
+    // simply take the bus back before the waiter got to it
+    bool used = xSemaphoreTake(slot_done, pdMS_TO_TICKS(BUS_ARBITER_SLOT_TIMEOUT_MS)) == pdTRUE;
+    slot_open = false;
+    return used;
+}
+
+void bus_arbiter_init() {
+    if (bus_mutex) return;
+    bus_mutex = xSemaphoreCreateRecursiveMutex();
+    slot_done = xSemaphoreCreateBinary();
+    bus_arbiter_reset_stats();
+    ESP_LOGI(TAG, "Bus arbiter ready (%d slots per display transaction)", BUS_ARBITER_MAX_YIELDS);
+}
+
+bool bus_arbiter_acquire(bus_client_t client, uint32_t timeout_ms) {
+    if (!take(client, to_ticks(timeout_ms))) {
+        stats[client].timeouts++;
+        return false;
+    }
+    if (depth++ == 0) {
+        begin_hold(client);
+        stats[client].transactions++;
+    }
+    return true;
+}
+
+void bus_arbiter_release(bus_client_t client) {
+    if (depth == 0) return;
+
+    bool returned_slot = false;
+    bool hand_over = false;
+    if (--depth == 0) {
+        returned_slot = hold_in_slot;
+        // The display takes the bus straight back for its next frame; a
+        // plain give would let it win the race with touch every time
+        hand_over = client == BUS_CLIENT_DISPLAY && others_waiting(client);
+        end_hold();
+    }
+
+    if (hand_over) {
+        if (lend_slot()) stats[client].yields++;
+    } else {
+        xSemaphoreGiveRecursive(bus_mutex);
+    }
+
+    // Wake the holder that lent us the bus
+    if (returned_slot) xSemaphoreGive(slot_done);
+}
+
+bool bus_arbiter_contended(bus_client_t holder_client) {
+    if (depth != 1 || hold_yields >= BUS_ARBITER_MAX_YIELDS) return false;
+    return others_waiting(holder_client);
+}
+
+bool bus_arbiter_yield(bus_client_t holder_client) {
+    if (!bus_arbiter_contended(holder_client)) return false;
+
+    uint32_t yields = hold_yields + 1;
+    end_hold();
+    depth = 0;
+    bool used = lend_slot();
+
+    // Same transaction, resumed
+    take(holder_client, portMAX_DELAY);
+    depth = 1;
+    begin_hold(holder_client);
+    hold_yields = yields;
+
+    if (used) stats[holder_client].yields++;
+    return used;
+}
+
+const char* bus_arbiter_client_name(bus_client_t client) {
+    switch (client) {
+        case BUS_CLIENT_DISPLAY: return "display";
+        case BUS_CLIENT_TOUCH: return "touch";
+        default: return "?";
+    }
+}
+
+void bus_arbiter_get_stats(bus_client_t client, bus_client_stats_t *out) {
+    if (out && client < BUS_CLIENT_COUNT) *out = stats[client];
+}
+
+void bus_arbiter_reset_stats() {
+    memset(stats, 0, sizeof(stats));
+}
@@ -0,0 +1,78 @@
+#ifndef BUS_ARBITER_HPP
+#define BUS_ARBITER_HPP
+
+#include <stdint.h>
+
+/**
+ * Arbiter for the HSPI bus shared by the ILI9488 and the XPT2046
+ *
+ * Both devices sit on pins 18/23/19; the display writes at 40 MHz, touch
+ * reads at 2.5 MHz. Every user takes the bus through the arbiter, which
+ * serializes them and accounts per client how long the bus was held, how
+ * long each waited for it and how many transactions it ran.
+ *
+ * The display holds the bus for a whole frame transaction, from the first
+ * flush of a frame until its last buffer is on the panel (LV_EVENT_REFR_READY
+ * in the DMA modes), so a still screen holds nothing. Between two
+ * flush chunks it calls bus_arbiter_yield(): when touch is waiting, the bus
+ * is handed over for one read and taken back, so a touch sample costs one
+ * gap between chunks instead of waiting for the end of the frame. The
+ * display's final release hands over the same way, so a frame with a
+ * single chunk, or the next frame starting right away, cannot keep
+ * winning the bus back from a waiting read.
+ */
+
+typedef enum {
+    BUS_CLIENT_DISPLAY = 0,
+    BUS_CLIENT_TOUCH,
+    BUS_CLIENT_COUNT
+} bus_client_t;
+
+// Slots the display hands out per transaction (caps how much touch can stretch a frame)
+#ifndef BUS_ARBITER_MAX_YIELDS
+#define BUS_ARBITER_MAX_YIELDS 4
+#endif
+
+// Longest the holder waits for a yielded slot to be used and returned
+#ifndef BUS_ARBITER_SLOT_TIMEOUT_MS
+#define BUS_ARBITER_SLOT_TIMEOUT_MS 2
+#endif
+
+typedef struct {
+    uint32_t transactions;     // Outermost acquire/release pairs
+    uint32_t timeouts;         // Acquires that gave up
+    uint32_t yields;           // Slots handed out (display) or taken (touch), mid-transaction or at its release
+    uint64_t busy_us;          // Time holding the bus
+    uint64_t wait_us;          // Time blocked in acquire
+    uint32_t max_wait_us;
+} bus_client_stats_t;
+
+// Create the lock; called by init_display()
+void bus_arbiter_init();
+
+/**
+ * Take the bus for client, waiting at most timeout_ms (UINT32_MAX = forever)
+ *
+ * Recursive for the task that already holds it. Returns false on timeout.
+ */
+bool bus_arbiter_acquire(bus_client_t client, uint32_t timeout_ms);
+
+// The display's outermost release waits up to BUS_ARBITER_SLOT_TIMEOUT_MS for a waiting client
+void bus_arbiter_release(bus_client_t client);
+
+/**
+ * Let waiting clients use the bus, then take it back
+ *
+ * Only for the holder, between its own transfers, with no transaction
+ * open on the panel. Returns true when a slot was handed out.
+ */
+bool bus_arbiter_yield(bus_client_t holder);
+
+// Another client is blocked on the bus and the holder may still yield
+bool bus_arbiter_contended(bus_client_t holder);
+
+const char* bus_arbiter_client_name(bus_client_t client);
+void bus_arbiter_get_stats(bus_client_t client, bus_client_stats_t *stats);
+void bus_arbiter_reset_stats();
+
+#endif // BUS_ARBITER_HPP
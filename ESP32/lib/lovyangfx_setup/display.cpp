@@ -1,4 +1,5 @@
 #include "display.hpp"
+#include "bus_arbiter.hpp"
 #include "esp_log.h"
 #include "SPIFFS.h"
 #include "FS.h"
@@ -12,7 +13,8 @@ LGFX gfx;
 void init_display() {
     ESP_LOGI(TAG, "Initializing LovyanGFX display...");
     gfx.init();
-    gfx.setRotation(0);  // Portrait mode: 320x480
+    bus_arbiter_init();
+    gfx.setRotation(TFT_ROTATION);  // The panel scans in this orientation; LVGL never rotates
     gfx.setBrightness(255);  // Full brightness
     gfx.fillScreen(0x0000);  // Clear screen to black
     ESP_LOGI(TAG, "LovyanGFX display initialized");
@@ -56,14 +58,19 @@ void touch_calibrate() {
     } else {
         ESP_LOGI(TAG, "No calibration found, running calibration...");
 
+        // Calibrate in portrait (320x480) whatever the boot orientation, so
+        // the saved data stays valid; getTouch() follows later rotations
+        uint8_t rotation = gfx.getRotation();
+        gfx.setRotation(0);
+
         gfx.fillScreen(0x0000);  // Black
         gfx.setTextColor(0xFFFF);  // White
         gfx.setTextSize(2);
         gfx.drawString("TOUCH THE ARROW MARKER", 30, 100);
 
-        // Run calibration in current portrait mode (320x480)
         // Size parameter: reasonable marker size for our screen
         gfx.calibrateTouch(cal_data, 0xFFFFFFU, 0x000000U, 15);
+        gfx.setRotation(rotation);
 
         // Log the calibration values
         ESP_LOGI(TAG, "Calibration complete! Values: [%d, %d, %d, %d, %d, %d, %d, %d]",
@@ -6,6 +6,12 @@
 // TFT Configuration
 #define TFT_HOR_RES 320
 #define TFT_VER_RES 480
+// Boot orientation as LovyanGFX rotation: 0/2 portrait 320x480, 1/3 landscape 480x320.
+// TFT_HOR_RES/TFT_VER_RES stay the panel's native (portrait) size.
+#ifndef TFT_ROTATION
+#define TFT_ROTATION 0
+#endif
+#define TFT_WIRE_BYTES_PER_PIXEL 3  // ILI9488 over SPI only accepts 18-bit color
 
 // Initialize display and touch
 void init_display();
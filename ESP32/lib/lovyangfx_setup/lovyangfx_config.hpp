@@ -4,6 +4,13 @@
 #define LGFX_USE_V1
 #include <LovyanGFX.hpp>
 
+#ifndef TFT_TOUCH_OFFSET_ROTATION
+#define TFT_TOUCH_OFFSET_ROTATION 0
+#endif
+
+// XPT2046 PENIRQ, low while the panel is pressed (wakes the touch sampling task)
+#define TFT_TOUCH_PIN_INT 27
+
 /**
  * LovyanGFX configuration for ILI9488 3.5" 320x480 display
  * Hardware: ESP32 with resistive touch
@@ -77,9 +84,11 @@ public:
       cfg.x_max      = 319;         // Maximum X value obtained from touch screen
       cfg.y_min      = 0;           // Minimum Y value obtained from touch screen
       cfg.y_max      = 479;         // Maximum Y value obtained from touch screen
-      cfg.pin_int    = 27;          // Touch interrupt pin
+      cfg.pin_int    = TFT_TOUCH_PIN_INT; // Touch interrupt pin
       cfg.bus_shared = true;        // Set true when sharing SPI bus with screen
-      cfg.offset_rotation = 0;      // Adjustment when touch orientation doesn't match display
+      // Mounting correction between touch film and panel (0~7). setRotation()
+      // is applied on top by LovyanGFX, so touch follows runtime rotation.
+      cfg.offset_rotation = TFT_TOUCH_OFFSET_ROTATION;
 
       // SPI bus settings for touch - try slower frequency for better stability
       cfg.spi_host = HSPI_HOST;
@@ -95,6 +104,15 @@ public:
 
     setPanel(&_panel_instance);
   }
+
+  // Bytes already in the panel's wire format (R,G,B, 3 per pixel) go to the
+  // bus as they are: writePixels() would run them through LovyanGFX's color
+  // conversion to rgb666 again. Inside startWrite(), after setAddrWindow();
+  // data must be DMA-capable and stay untouched until waitDMA().
+  void writeWireBytesDMA(const uint8_t* data, uint32_t len)
+  {
+    _bus_instance.writeBytes(data, len, true, true);
+  }
 };
 
 #endif // LOVYANGFX_CONFIG_HPP
@@ -0,0 +1,309 @@
+#include "draw_buffers.hpp"
+#include "lvgl_setup.hpp"
+#include "display.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char* TAG = "DRAW_BUF";
+
+static lv_display_t *buf_disp = NULL;
+static void *bufs[2] = {NULL, NULL};
+static uint32_t buf_caps = 0;
+static draw_buffers_config_t config;
+
+#if LVGL_FLUSH_MODE == LVGL_FLUSH_ASYNC && DRAW_BUF_CALIBRATION_FRAMES > 0
+#define DRAW_BUF_CALIBRATE 1
+#else
+#define DRAW_BUF_CALIBRATE 0
+#endif
+
+#if DRAW_BUF_CALIBRATE
+// Calibration state, per frame and accumulated
+static bool in_frame = false;
+static int64_t frame_start_us = 0;
+static uint32_t frame_px = 0;
+static uint32_t frame_stall_us = 0;
+static uint32_t calib_frames = 0;
+static uint64_t calib_render_us = 0;
+static uint64_t calib_flush_us = 0;
+#endif
+
+// Bytes per line at the display's current orientation
+static uint32_t row_bytes() {
+    return lv_display_get_horizontal_resolution(buf_disp) * (LV_COLOR_DEPTH / 8);
+}
+
+static int32_t screen_rows() {
+    return lv_display_get_vertical_resolution(buf_disp);
+}
+
+static void free_buffers() {
+    heap_caps_free(bufs[0]);
+    heap_caps_free(bufs[1]);
+    bufs[0] = bufs[1] = NULL;
+}
+
+static bool try_allocate(int32_t rows, bool double_buffered, uint32_t caps) {
+    uint32_t bytes = rows * row_bytes();
+    bufs[0] = heap_caps_malloc(bytes, caps);
+    if (bufs[0] && double_buffered) {
+        bufs[1] = heap_caps_malloc(bytes, caps);
+    }
+    if (!bufs[0] || (double_buffered && !bufs[1])) {
+        free_buffers();
+        return false;
+    }
+
+    buf_caps = caps;
+    config.rows = rows;
+    config.bytes = bytes;
+    config.double_buffered = double_buffered;
+    config.dma_capable = (caps & MALLOC_CAP_DMA) != 0;
+    return true;
+}
+
+// Largest multiple of DRAW_BUF_ROW_STEP up to max_rows for which count buffers fit the probed heap
+static int32_t rows_for_budget(int32_t max_rows, int count) {
+    uint32_t budget = 0;
+    if (config.dma_free > DRAW_BUF_DMA_RESERVE) {
+        budget = (config.dma_free - DRAW_BUF_DMA_RESERVE) / count;
+    }
+    if (budget > config.dma_largest) budget = config.dma_largest;
+
+    int32_t rows = budget / row_bytes();
+    if (rows > max_rows) rows = max_rows;
+    if (rows > screen_rows()) rows = screen_rows();
+    rows -= rows % DRAW_BUF_ROW_STEP;
+    // The probe can be pessimistic; the ladder still tries the minimum
+    return rows < DRAW_BUF_MIN_ROWS ? DRAW_BUF_MIN_ROWS : rows;
+}
+
+/**
+ * Fallback ladder, each stage shrinking by DRAW_BUF_ROW_STEP down to
+ * DRAW_BUF_MIN_ROWS: double DMA, single DMA, single internal RAM
+ * (LovyanGFX copies non-DMA memory through its own buffer).
+ */
+static bool allocate(int32_t max_rows, bool double_buffered) {
+    struct stage_t {
+        bool double_buffered;
+        uint32_t caps;
+    };
+    const stage_t stages[] = {
+        {true, MALLOC_CAP_DMA},
+        {false, MALLOC_CAP_DMA},
+        {false, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT},
+    };
+
+    for (const stage_t &stage : stages) {
+        if (stage.double_buffered && !double_buffered) continue;
+
+        for (int32_t rows = rows_for_budget(max_rows, stage.double_buffered ? 2 : 1);
+             rows >= DRAW_BUF_MIN_ROWS; rows -= DRAW_BUF_ROW_STEP) {
+            if (try_allocate(rows, stage.double_buffered, stage.caps)) {
+                return true;
+            }
+            config.fallback_steps++;
+        }
+    }
+    return false;
+}
+
+#if LVGL_RENDER_MODE != LVGL_RENDER_PARTIAL
+// One framebuffer for the whole screen: PSRAM first, internal RAM if it is that large
+static bool allocate_framebuffer() {
+    const uint32_t caps[] = {MALLOC_CAP_SPIRAM, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT};
+
+    for (uint32_t c : caps) {
+        if (try_allocate(screen_rows(), false, c)) {
+            config.render_mode = LVGL_RENDER_MODE == LVGL_RENDER_DIRECT ?
+                LV_DISPLAY_RENDER_MODE_DIRECT : LV_DISPLAY_RENDER_MODE_FULL;
+            return true;
+        }
+        config.fallback_steps++;
+    }
+    return false;
+}
+#endif
+
+static const char* render_mode_name(lv_display_render_mode_t mode) {
+    switch (mode) {
+        case LV_DISPLAY_RENDER_MODE_DIRECT: return "direct";
+        case LV_DISPLAY_RENDER_MODE_FULL: return "full";
+        default: return "partial";
+    }
+}
+
+static void apply_to_display() {
+    lv_display_set_buffers(buf_disp, bufs[0], bufs[1], config.bytes, config.render_mode);
+
+    ESP_LOGI(TAG, "%s mode, %s-buffered, %u lines (%u bytes each, %s), %u fallback steps, DMA heap %u free / %u largest",
+             render_mode_name(config.render_mode),
+             config.double_buffered ? "double" : "single", (unsigned)config.rows, (unsigned)config.bytes,
+             config.dma_capable ? "DMA" : "internal RAM", (unsigned)config.fallback_steps,
+             (unsigned)config.dma_free, (unsigned)config.dma_largest);
+}
+
+#if DRAW_BUF_CALIBRATE
+// Deferred from REFR_READY: LVGL must not be inside a refresh when buffers change
+static void switch_to_single(void *user_data) {
+    (void)user_data;
+
+    // The second buffer may still be on the wire
+    lvgl_flush_wait_idle();
+
+    uint32_t bytes = config.bytes;
+    int32_t rows = config.rows * 2;
+    if (rows > screen_rows()) rows = screen_rows();
+
+    heap_caps_free(bufs[1]);
+    bufs[1] = NULL;
+
+    // realloc leaves the original buffer intact when it cannot grow
+    void *grown = heap_caps_realloc(bufs[0], rows * row_bytes(), buf_caps);
+    if (grown) {
+        bufs[0] = grown;
+        config.rows = rows;
+        config.bytes = rows * row_bytes();
+        config.double_buffered = false;
+    } else {
+        bufs[1] = heap_caps_malloc(bytes, buf_caps);
+        if (bufs[1]) {
+            ESP_LOGW(TAG, "No room for a %d-line buffer, staying double-buffered", (int)rows);
+            return;
+        }
+        config.double_buffered = false;
+    }
+
+    apply_to_display();
+}
+
+static void decide_buffering() {
+    config.calibrated = true;
+    config.render_us = (uint32_t)(calib_render_us / calib_frames);
+    config.flush_us = (uint32_t)(calib_flush_us / calib_frames);
+
+    // Double buffering hides at most the shorter of the two per frame
+    uint64_t hidden = config.render_us < config.flush_us ? config.render_us : config.flush_us;
+    uint64_t total = (uint64_t)config.render_us + config.flush_us;
+    bool keep_double = hidden * 100 >= total * DRAW_BUF_OVERLAP_MIN_PCT;
+
+    ESP_LOGI(TAG, "Calibrated over %u frames: render %u us, flush %u us -> %s buffering",
+             (unsigned)calib_frames, (unsigned)config.render_us, (unsigned)config.flush_us,
+             keep_double ? "double" : "single");
+
+    if (!keep_double && config.double_buffered) {
+        lv_async_call(switch_to_single, NULL);
+    }
+}
+
+static void refr_start_event_cb(lv_event_t *e) {
+    (void)e;
+    if (config.calibrated) return;
+
+    in_frame = true;
+    frame_start_us = esp_timer_get_time();
+    frame_px = 0;
+    frame_stall_us = 0;
+}
+
+static void refr_ready_event_cb(lv_event_t *e) {
+    (void)e;
+    if (!in_frame) return;
+    in_frame = false;
+
+    // Frames that flushed nothing say nothing about the buffers
+    if (frame_px == 0) return;
+
+    uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - frame_start_us);
+    calib_render_us += elapsed_us > frame_stall_us ? elapsed_us - frame_stall_us : 0;
+    calib_flush_us += (uint64_t)frame_px * config.wire_ns_per_px / 1000;
+
+    if (++calib_frames >= DRAW_BUF_CALIBRATION_FRAMES) {
+        decide_buffering();
+    }
+}
+
+// The panel is black after init_display(), so a black fill changes nothing
+// on screen and costs the same wire time per pixel as a flush
+static void measure_wire_rate() {
+    uint32_t px = gfx.width() * gfx.height();
+    int64_t start = esp_timer_get_time();
+    gfx.fillScreen(0x0000);
+    uint64_t elapsed_us = esp_timer_get_time() - start;
+    config.wire_ns_per_px = (uint32_t)(elapsed_us * 1000 / px);
+}
+#endif
+
+bool draw_buffers_init(lv_display_t *disp) {
+    buf_disp = disp;
+    memset(&config, 0, sizeof(config));
+    config.render_mode = LV_DISPLAY_RENDER_MODE_PARTIAL;
+    config.dma_free = heap_caps_get_free_size(MALLOC_CAP_DMA);
+    config.dma_largest = heap_caps_get_largest_free_block(MALLOC_CAP_DMA);
+
+#if LVGL_RENDER_MODE != LVGL_RENDER_PARTIAL
+    if (allocate_framebuffer()) {
+        config.calibrated = true;  // A single framebuffer leaves nothing to decide
+        apply_to_display();
+        return true;
+    }
+    ESP_LOGW(TAG, "No room for a %d KB framebuffer, falling back to partial mode",
+             (int)(screen_rows() * row_bytes() / 1024));
+#endif
+
+#if LVGL_FLUSH_MODE != LVGL_FLUSH_BLOCKING
+    bool ok = allocate(DRAW_BUF_MAX_ROWS, true);
+#else
+    // Nothing overlaps a blocking flush: spend both buffers' memory on one
+    bool ok = allocate(DRAW_BUF_MAX_ROWS * 2, false);
+#endif
+    if (!ok) {
+        ESP_LOGE(TAG, "Failed to allocate display buffers");
+        return false;
+    }
+    apply_to_display();
+
+#if DRAW_BUF_CALIBRATE
+    if (config.double_buffered) {
+        measure_wire_rate();
+        lv_display_add_event_cb(disp, refr_start_event_cb, LV_EVENT_REFR_START, NULL);
+        lv_display_add_event_cb(disp, refr_ready_event_cb, LV_EVENT_REFR_READY, NULL);
+        return true;
+    }
+#endif
+    config.calibrated = true;  // Nothing left to decide
+    return true;
+}
+
+void draw_buffers_get_config(draw_buffers_config_t *out) {
+    *out = config;
+}
+
+void draw_buffers_update_resolution() {
+    // Same memory, new line width: LVGL derives stride and band height from
+    // the resolution when the buffers are set again
+    config.rows = config.bytes / row_bytes();
+    apply_to_display();
+}
+
+lv_display_render_mode_t draw_buffers_get_render_mode() {
+    return config.render_mode;
+}
+
+void draw_buffers_note_flush(uint32_t px) {
+#if DRAW_BUF_CALIBRATE
+    if (in_frame) frame_px += px;
+#else
+    (void)px;
+#endif
+}
+
+void draw_buffers_note_stall(uint32_t us) {
+#if DRAW_BUF_CALIBRATE
+    if (in_frame) frame_stall_us += us;
+#else
+    (void)us;
+#endif
+}
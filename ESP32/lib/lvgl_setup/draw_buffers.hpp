@@ -0,0 +1,93 @@
+#ifndef DRAW_BUFFERS_HPP
+#define DRAW_BUFFERS_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+
+/**
+ * LVGL draw buffer manager
+ *
+ * Sizes the partial-mode draw buffers from the DMA heap found at boot
+ * instead of a fixed fraction of the screen, and never leaves the device
+ * without a display: when an allocation fails it steps down through
+ * smaller buffers, single buffering and finally non-DMA memory.
+ *
+ * Double buffering only pays off when rendering and the SPI transfer can
+ * overlap. With LVGL_FLUSH_ASYNC the manager starts double-buffered, then
+ * measures render and wire time over the first frames; when the overlap
+ * would hide less than DRAW_BUF_OVERLAP_MIN_PCT of the frame, it switches to
+ * one buffer of twice the height (fewer render passes and windows). With
+ * LVGL_FLUSH_PIPELINE it stays double-buffered (the flush task works on one
+ * buffer while LVGL renders into the other). With LVGL_FLUSH_BLOCKING there
+ * is no overlap, so it goes single at once.
+ *
+ * With LVGL_RENDER_DIRECT / LVGL_RENDER_FULL it allocates one full-screen
+ * framebuffer instead, in PSRAM when the board has it (a plain host buffer
+ * in the native build), and falls back to partial mode when that fails.
+ */
+
+// Buffer height limits in lines (the old fixed /10 buffer was 48 lines)
+#ifndef DRAW_BUF_MAX_ROWS
+#define DRAW_BUF_MAX_ROWS 96
+#endif
+#ifndef DRAW_BUF_MIN_ROWS
+#define DRAW_BUF_MIN_ROWS 8
+#endif
+// Lines dropped per fallback step
+#ifndef DRAW_BUF_ROW_STEP
+#define DRAW_BUF_ROW_STEP 8
+#endif
+
+// DMA-capable bytes left for the SPI driver, bounce buffers and the rest of the app
+#ifndef DRAW_BUF_DMA_RESERVE
+#define DRAW_BUF_DMA_RESERVE (32 * 1024)
+#endif
+
+// Frames measured before the single/double decision (0 = keep the boot choice)
+#ifndef DRAW_BUF_CALIBRATION_FRAMES
+#define DRAW_BUF_CALIBRATION_FRAMES 30
+#endif
+
+// Minimum share of render+flush time that overlap must hide to keep double buffering
+#ifndef DRAW_BUF_OVERLAP_MIN_PCT
+#define DRAW_BUF_OVERLAP_MIN_PCT 10
+#endif
+
+typedef struct {
+    lv_display_render_mode_t render_mode;  // PARTIAL after a framebuffer fallback
+    uint32_t rows;             // Buffer height in lines
+    uint32_t bytes;            // Size of each buffer
+    bool double_buffered;
+    bool dma_capable;          // false for PSRAM framebuffers and the internal RAM fallback
+    uint32_t fallback_steps;   // Candidates that failed to allocate before this one
+    uint32_t dma_free;         // MALLOC_CAP_DMA free bytes at probe time
+    uint32_t dma_largest;      // Largest free MALLOC_CAP_DMA block at probe time
+    // Calibration (async flush only)
+    bool calibrated;
+    uint32_t wire_ns_per_px;   // Measured at boot with a full-screen fill
+    uint32_t render_us;        // Average per frame, excluding time blocked on the bus
+    uint32_t flush_us;         // Average per frame, flushed pixels x wire_ns_per_px
+} draw_buffers_config_t;
+
+/**
+ * Probe the heap, allocate the draw buffers and attach them to disp
+ *
+ * Returns false only when not even a single DRAW_BUF_MIN_ROWS buffer
+ * could be allocated.
+ */
+bool draw_buffers_init(lv_display_t *disp);
+
+// Current configuration (also logged whenever it changes)
+void draw_buffers_get_config(draw_buffers_config_t *config);
+
+// Re-attach the buffers after lv_display_set_resolution() (panel rotation)
+void draw_buffers_update_resolution();
+
+// Render mode actually in use; the flush callback interprets px_map by it
+lv_display_render_mode_t draw_buffers_get_render_mode();
+
+// Flush path hooks: pixels handed to the panel, and time spent blocked on the bus
+void draw_buffers_note_flush(uint32_t px);
+void draw_buffers_note_stall(uint32_t us);
+
+#endif // DRAW_BUFFERS_HPP
@@ -0,0 +1,120 @@
+#include "flush_encoder.hpp"
+#include "pixel_convert.hpp"
+#include "display.hpp"
+#include <string.h>
+
+static flush_encoder_stats_t stats;
+
+// Length of the run of pixels equal to row[start]
+static int32_t run_length(const flush_px_t *row, int32_t start, int32_t w) {
+    flush_px_t color = row[start];
+    int32_t end = start + 1;
+    while (end < w && row[end] == color) end++;
+    return end - start;
+}
+
+static bool row_is_uniform(const flush_px_t *row, int32_t w) {
+    return run_length(row, 0, w) == w;
+}
+
+static void write_raw(int32_t x, int32_t y, int32_t w, int32_t h,
+                      const flush_px_t *px, int32_t stride, bool use_dma) {
+    gfx.setAddrWindow(x, y, w, h);
+
+    if (stride == w) {
+        // Rows are contiguous: one transfer for the whole block
+        pixel_convert_write(px, w * h, use_dma);
+        stats.raw_ops++;
+    } else {
+        // The panel wraps inside the window, so rows can follow each other
+        for (int32_t r = 0; r < h; r++) {
+            pixel_convert_write(px + r * stride, w, use_dma);
+            stats.raw_ops++;
+        }
+    }
+    stats.raw_pixels += (uint64_t)w * h;
+}
+
+static void write_fill(int32_t x, int32_t y, int32_t w, int32_t h, flush_px_t px) {
+    if (h == 1) gfx.writeFastHLine(x, y, w, flush_px_color(px));
+    else gfx.writeFillRect(x, y, w, h, flush_px_color(px));
+    stats.fill_ops++;
+    stats.fill_pixels += (uint64_t)w * h;
+}
+
+// Mixed row with at least one long uniform span: split it into raw and fill segments
+static void write_row_segments(int32_t x, int32_t y, const flush_px_t *row, int32_t w, bool use_dma) {
+    int32_t raw_start = 0;
+    int32_t i = 0;
+
+    while (i < w) {
+        int32_t run = run_length(row, i, w);
+        if (run >= FLUSH_RLE_MIN_RUN) {
+            if (i > raw_start) {
+                write_raw(x + raw_start, y, i - raw_start, 1, row + raw_start, i - raw_start, use_dma);
+            }
+            write_fill(x + i, y, run, 1, row[i]);
+            raw_start = i + run;
+        }
+        i += run;
+    }
+    if (w > raw_start) {
+        write_raw(x + raw_start, y, w - raw_start, 1, row + raw_start, w - raw_start, use_dma);
+    }
+}
+
+static bool row_has_long_run(const flush_px_t *row, int32_t w) {
+    if (w < FLUSH_RLE_MIN_RUN) return false;
+    for (int32_t i = 0; i < w; ) {
+        int32_t run = run_length(row, i, w);
+        if (run >= FLUSH_RLE_MIN_RUN) return true;
+        i += run;
+    }
+    return false;
+}
+
+void flush_encoder_write(const lv_area_t *area, const flush_px_t *px, int32_t stride, bool use_dma) {
+    const int32_t x = area->x1;
+    const int32_t w = area->x2 - area->x1 + 1;
+    const int32_t h = area->y2 - area->y1 + 1;
+    stats.areas++;
+
+    // A fill blocks the CPU for its wire time; a DMA write does not
+    if (!FLUSH_FILL_DETECT || use_dma) {
+        write_raw(x, area->y1, w, h, px, stride, use_dma);
+        return;
+    }
+
+    // Walk the rows, grouping consecutive rows of the same kind:
+    //  - uniform rows of one color  -> one writeFillRect
+    //  - plain mixed rows           -> one raw window
+    //  - mixed rows with long spans -> per-row segments
+    int32_t r = 0;
+    while (r < h) {
+        const flush_px_t *row = px + r * stride;
+        int32_t start = r;
+
+        if (row_is_uniform(row, w)) {
+            flush_px_t color = row[0];
+            r++;
+            while (r < h && px[r * stride] == color && row_is_uniform(px + r * stride, w)) r++;
+            if (start == 0 && r == h) stats.uniform_areas++;
+            write_fill(x, area->y1 + start, w, r - start, color);
+        } else if (row_has_long_run(row, w)) {
+            write_row_segments(x, area->y1 + r, row, w, use_dma);
+            r++;
+        } else {
+            r++;
+            while (r < h && !row_is_uniform(px + r * stride, w) && !row_has_long_run(px + r * stride, w)) r++;
+            write_raw(x, area->y1 + start, w, r - start, row, stride, use_dma);
+        }
+    }
+}
+
+void flush_encoder_get_stats(flush_encoder_stats_t *out) {
+    if (out) *out = stats;
+}
+
+void flush_encoder_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,60 @@
+#ifndef FLUSH_ENCODER_HPP
+#define FLUSH_ENCODER_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+#include "flush_pixel.hpp"
+
+/**
+ * Flush encoder: turns one rendered LVGL area into panel operations
+ *
+ * Uniform areas, runs of identical uniform rows and long uniform spans
+ * inside a row are sent as fill commands (writeFillRect / writeFastHLine).
+ * Everything else is streamed through the selected pixel pipeline.
+ *
+ * Note: the ILI9488 has no on-chip fill command, so a fill still clocks
+ * every pixel over SPI. What it saves is the per-pixel color conversion
+ * and the DMA read of the draw buffer: LovyanGFX converts the color once
+ * and repeats it from the SPI data registers.
+ *
+ * A fill is a CPU write, though, so with DMA flushes it would block the
+ * rendering task for the whole wire time, and split rows cost extra
+ * windows and small transfers. Fills are therefore only used for blocking
+ * (non-DMA) writes, and only when enabled.
+ */
+
+// Set to 1 to send uniform areas of blocking writes as fills. Off until a
+// benchmark shows it wins on this panel
+#ifndef FLUSH_FILL_DETECT
+#define FLUSH_FILL_DETECT 0
+#endif
+
+// Minimum uniform span (pixels) worth its own window inside a mixed row.
+// Each split adds two address windows (22 bytes), so short runs stay raw.
+#ifndef FLUSH_RLE_MIN_RUN
+#define FLUSH_RLE_MIN_RUN 96
+#endif
+
+typedef struct {
+    uint32_t areas;            // Areas encoded
+    uint32_t uniform_areas;    // Areas sent as a single fill
+    uint32_t fill_ops;         // writeFillRect / writeFastHLine calls
+    uint32_t raw_ops;          // writePixels calls
+    uint64_t fill_pixels;      // Pixels sent via fill commands
+    uint64_t raw_pixels;       // Pixels streamed from the draw buffer
+} flush_encoder_stats_t;
+
+/**
+ * Write one area to the panel (caller holds the transaction)
+ *
+ * @param area   Screen area covered by px
+ * @param px     Pixels of the area's first row
+ * @param stride Pixels between the starts of consecutive rows in px
+ * @param use_dma Stream raw pixels with DMA (the last transfer may still be in flight on return)
+ */
+void flush_encoder_write(const lv_area_t *area, const flush_px_t *px, int32_t stride, bool use_dma);
+
+void flush_encoder_get_stats(flush_encoder_stats_t *stats);
+void flush_encoder_reset_stats();
+
+#endif // FLUSH_ENCODER_HPP
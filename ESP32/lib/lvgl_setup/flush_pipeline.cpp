@@ -0,0 +1,186 @@
+#include "flush_pipeline.hpp"
+#include "flush_scheduler.hpp"
+#include "shadow_fb.hpp"
+#include "perf_metrics.hpp"
+#include "spsc_ring.hpp"
+#include "display.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <atomic>
+#include <string.h>
+
+#ifndef NATIVE_BUILD
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#endif
+
+static const char* TAG = "FLUSH_PIPE";
+
+static spsc_ring<flush_job_t, FLUSH_PIPELINE_QUEUE> queue;
+static std::atomic<uint32_t> submitted{0};
+static std::atomic<uint32_t> completed{0};
+static uint32_t returned = 0;                 // Buffers handed back to LVGL (LVGL task)
+static std::atomic<int64_t> done_us{0};       // When the last job was on the panel (esp_timer)
+
+// Each side only writes its own counters; the report (LVGL task) reads and
+// resets the flush side through the atomics
+static struct {
+    uint32_t jobs;
+    uint32_t max_depth;
+    uint64_t depth_sum;
+    uint32_t stalls;
+    uint64_t stall_us;
+} render;                                     // LVGL task
+
+static struct {
+    std::atomic<uint32_t> stalls{0};
+    std::atomic<uint64_t> stall_us{0};
+    std::atomic<uint64_t> busy_us{0};
+} flush;                                      // Flush task
+
+#ifndef NATIVE_BUILD
+static TaskHandle_t flush_task = NULL;
+static SemaphoreHandle_t job_done = NULL;  // Given after every job
+#endif
+
+// Flush side: the same chain the other flush modes run in the flush callback
+static void write_job(const flush_job_t &job) {
+    int64_t start = esp_timer_get_time();
+    int64_t perf_start = perf_metrics_now_us();
+
+    flush_scheduler_window_begin();
+    shadow_fb_write(&job.write.area, job.write.px, job.write.stride, true);
+    // The buffer goes back to LVGL: nothing may still read it
+    gfx.waitDMA();
+    flush_scheduler_window_done(job.last);
+
+    int64_t end = esp_timer_get_time();
+    flush.busy_us += (uint64_t)(end - start);
+    perf_metrics_record(PERF_FLUSH, (uint32_t)(perf_metrics_now_us() - perf_start));
+    done_us = end;
+    completed++;
+}
+
+#ifndef NATIVE_BUILD
+static void flush_task_fn(void *arg) {
+    (void)arg;
+    bool frame_open = false;
+    flush_job_t job;
+
+    for (;;) {
+        if (!queue.pop(&job)) {
+            int64_t wait_start = esp_timer_get_time();
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            // Idle between frames is expected; inside one, LVGL is behind
+            if (frame_open) {
+                flush.stalls++;
+                flush.stall_us += (uint64_t)(esp_timer_get_time() - wait_start);
+            }
+            continue;
+        }
+        write_job(job);
+        frame_open = !job.last;
+        xSemaphoreGive(job_done);
+    }
+}
+#endif
+
+// Which side of the render/flush pipeline waited for the other since the last report
+static void report() {
+    flush_pipeline_stats_t pipe;
+    flush_pipeline_get_stats(&pipe);
+    ESP_LOGI(TAG, "PIPELINE - %lu buffers, queue depth %lu.%02lu avg (max %lu), render stalls %lu (%llu ms), flush stalls %lu (%llu ms), flush busy %llu ms",
+             (unsigned long)pipe.jobs, (unsigned long)(pipe.avg_depth_x100 / 100),
+             (unsigned long)(pipe.avg_depth_x100 % 100), (unsigned long)pipe.max_depth,
+             (unsigned long)pipe.render_stalls, (unsigned long long)(pipe.render_stall_us / 1000),
+             (unsigned long)pipe.flush_stalls, (unsigned long long)(pipe.flush_stall_us / 1000),
+             (unsigned long long)(pipe.flush_busy_us / 1000));
+    flush_pipeline_reset_stats();
+}
+
+bool flush_pipeline_init() {
+    flush_pipeline_reset_stats();
+    perf_metrics_add_report(report);
+
+#ifndef NATIVE_BUILD
+    job_done = xSemaphoreCreateBinary();
+    if (!job_done ||
+        xTaskCreatePinnedToCore(flush_task_fn, "flush", 4096, NULL,
+                                FLUSH_PIPELINE_PRIORITY, &flush_task, FLUSH_PIPELINE_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create the flush task");
+        return false;
+    }
+    ESP_LOGI(TAG, "Flush task on core %d, %d queue slots", FLUSH_PIPELINE_CORE, FLUSH_PIPELINE_QUEUE - 1);
+#else
+    ESP_LOGI(TAG, "Flush pipeline runs inline (no second core in the native build)");
+#endif
+    return true;
+}
+
+void flush_pipeline_submit(const flush_job_t *job) {
+    uint32_t depth = submitted - completed + 1;
+    render.jobs++;
+    render.depth_sum += depth;
+    if (depth > render.max_depth) render.max_depth = depth;
+
+#ifdef NATIVE_BUILD
+    submitted++;
+    write_job(*job);
+#else
+    // Counted first, so the job is never done before it was submitted
+    submitted++;
+    // LVGL never has more buffers out than the queue holds; wait if it ever does
+    while (!queue.push(*job)) {
+        int64_t wait_start = esp_timer_get_time();
+        xSemaphoreTake(job_done, portMAX_DELAY);
+        render.stalls++;
+        render.stall_us += (uint64_t)(esp_timer_get_time() - wait_start);
+    }
+    xTaskNotifyGive(flush_task);
+#endif
+}
+
+bool flush_pipeline_busy() {
+    return completed != submitted;
+}
+
+bool flush_pipeline_outstanding() {
+    return returned != submitted;
+}
+
+int64_t flush_pipeline_wait() {
+    if (flush_pipeline_busy()) {
+        int64_t wait_start = esp_timer_get_time();
+#ifndef NATIVE_BUILD
+        // job_done may hold a give from a job already counted; the loop re-checks
+        while (flush_pipeline_busy()) {
+            xSemaphoreTake(job_done, portMAX_DELAY);
+        }
+#endif
+        render.stalls++;
+        render.stall_us += (uint64_t)(esp_timer_get_time() - wait_start);
+    }
+    returned = submitted;
+    return done_us;
+}
+
+void flush_pipeline_get_stats(flush_pipeline_stats_t *out) {
+    if (!out) return;
+    out->jobs = render.jobs;
+    out->max_depth = render.max_depth;
+    out->avg_depth_x100 = render.jobs ? (uint32_t)(render.depth_sum * 100 / render.jobs) : 0;
+    out->render_stalls = render.stalls;
+    out->render_stall_us = render.stall_us;
+    out->flush_stalls = flush.stalls;
+    out->flush_stall_us = flush.stall_us;
+    out->flush_busy_us = flush.busy_us;
+}
+
+// A flush-side increment between get and reset is lost, not torn
+void flush_pipeline_reset_stats() {
+    memset(&render, 0, sizeof(render));
+    flush.stalls = 0;
+    flush.stall_us = 0;
+    flush.busy_us = 0;
+}
@@ -0,0 +1,91 @@
+#ifndef FLUSH_PIPELINE_HPP
+#define FLUSH_PIPELINE_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+#include "flush_pixel.hpp"
+
+/**
+ * Two-core render/flush pipeline (LVGL_FLUSH_PIPELINE)
+ *
+ * LVGL renders in the loop task (ARDUINO_RUNNING_CORE, core 1). Its flush
+ * callback only queues the rendered buffer; a flush task pinned to the other
+ * core takes it from a bounded queue, runs the shadow/encoder/pixel chain
+ * and the SPI transfer, and returns the buffer. Meanwhile LVGL renders the
+ * next band into the other draw buffer, so with two buffers the pixel
+ * conversion leaves the render core as well as the wire time.
+ *
+ * The flush task holds the display's bus transactions (flush_scheduler),
+ * so touch reads still get their slots between windows. LVGL takes a
+ * buffer back through flush_wait_cb (flush_pipeline_wait()); a frame's
+ * last buffer is waited for at LV_EVENT_REFR_READY, so frame statistics
+ * and the shadow are never touched by both tasks at once. The flush task
+ * only stamps when a job was done; lv_display_flush_ready() and the
+ * latency bookkeeping always run in the LVGL task, for every buffer it
+ * handed out, even when the job finished before anyone waited for it.
+ *
+ * In the native build there is no second task: a job is written when it
+ * is submitted.
+ */
+
+#ifndef FLUSH_PIPELINE_CORE
+#define FLUSH_PIPELINE_CORE 0
+#endif
+
+// Between the touch sampler (3) and the loop task (1)
+#ifndef FLUSH_PIPELINE_PRIORITY
+#define FLUSH_PIPELINE_PRIORITY 2
+#endif
+
+// Queue slots (power of two, holds one less); LVGL itself has at most
+// one buffer out while it renders into the other
+#ifndef FLUSH_PIPELINE_QUEUE
+#define FLUSH_PIPELINE_QUEUE 4
+#endif
+
+// One shadow_fb_write() call
+typedef struct {
+    lv_area_t area;
+    const flush_px_t *px;
+    int32_t stride;
+} flush_write_t;
+
+// One rendered buffer, as handed to the flush callback
+typedef struct {
+    flush_write_t write;
+    bool last;                 // Last flush of the frame: closes the bus transaction
+} flush_job_t;
+
+typedef struct {
+    uint32_t jobs;             // Buffers queued
+    uint32_t max_depth;        // Most jobs queued or in progress at a submit
+    uint32_t avg_depth_x100;   // Average of the same, x100
+    // Render side (LVGL task)
+    uint32_t render_stalls;    // Waits for a buffer still owned by the flush task
+    uint64_t render_stall_us;
+    // Flush side (flush task)
+    uint32_t flush_stalls;     // Waits for the next buffer in the middle of a frame
+    uint64_t flush_stall_us;
+    uint64_t flush_busy_us;    // Converting and transferring
+} flush_pipeline_stats_t;
+
+// Start the flush task (call from init_lvgl_display)
+bool flush_pipeline_init();
+
+// Queue a rendered buffer (LVGL task)
+void flush_pipeline_submit(const flush_job_t *job);
+
+// Jobs queued or in progress
+bool flush_pipeline_busy();
+
+// Buffers submitted but not yet taken back by flush_pipeline_wait() (LVGL task)
+bool flush_pipeline_outstanding();
+
+// Block until every queued buffer is on the panel and take them all back;
+// returns when the last one got there (esp_timer) (LVGL task)
+int64_t flush_pipeline_wait();
+
+void flush_pipeline_get_stats(flush_pipeline_stats_t *stats);
+void flush_pipeline_reset_stats();
+
+#endif // FLUSH_PIPELINE_HPP
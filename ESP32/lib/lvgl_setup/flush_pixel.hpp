@@ -0,0 +1,46 @@
+#ifndef FLUSH_PIXEL_HPP
+#define FLUSH_PIXEL_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+
+/**
+ * Draw buffer pixel type for the flush path, following LV_COLOR_DEPTH
+ *
+ * flush_px_color() returns the value LovyanGFX fill calls expect:
+ * uint16_t is read as RGB565, uint32_t as 0xRRGGBB.
+ */
+#if LV_COLOR_DEPTH == 24
+
+// LVGL stores 24-bit pixels as B, G, R in memory
+typedef struct __attribute__((packed)) {
+    uint8_t b;
+    uint8_t g;
+    uint8_t r;
+} flush_px_t;
+
+static inline bool operator==(const flush_px_t &a, const flush_px_t &b) {
+    return a.b == b.b && a.g == b.g && a.r == b.r;
+}
+
+static inline bool operator!=(const flush_px_t &a, const flush_px_t &b) {
+    return !(a == b);
+}
+
+static inline uint32_t flush_px_color(flush_px_t p) {
+    return ((uint32_t)p.r << 16) | ((uint32_t)p.g << 8) | p.b;
+}
+
+#elif LV_COLOR_DEPTH == 16
+
+typedef uint16_t flush_px_t;
+
+static inline uint16_t flush_px_color(flush_px_t p) {
+    return p;
+}
+
+#else
+#error "Flush path supports LV_COLOR_DEPTH 16 or 24"
+#endif
+
+#endif // FLUSH_PIXEL_HPP
@@ -0,0 +1,133 @@
+#include "flush_scheduler.hpp"
+#include "display.hpp"
+#include "bus_arbiter.hpp"
+#include "esp_log.h"
+#include <src/display/lv_display_private.h>
+#include <string.h>
+
+static const char* TAG = "FLUSH_SCHED";
+
+static flush_scheduler_stats_t stats;
+static bool transaction_open = false;
+
+// Pixel cost of sending an area as its own window
+static uint32_t window_cost(const lv_area_t *area) {
+    return lv_area_get_size(area) + FLUSH_WINDOW_OVERHEAD_PX;
+}
+
+/**
+ * Greedily merge pairs of invalidated areas while one window over their
+ * union costs no more than sending both. Merged areas are marked as joined
+ * so LVGL skips them; LVGL's own join runs afterwards on what is left.
+ */
+static uint32_t merge_invalid_areas(lv_display_t *disp) {
+    uint32_t merged = 0;
+    bool changed = true;
+
+    while (changed) {
+        changed = false;
+        for (uint32_t i = 0; i < disp->inv_p; i++) {
+            if (disp->inv_area_joined[i]) continue;
+
+            for (uint32_t j = i + 1; j < disp->inv_p; j++) {
+                if (disp->inv_area_joined[j]) continue;
+
+                lv_area_t joined;
+                lv_area_join(&joined, &disp->inv_areas[i], &disp->inv_areas[j]);
+
+                // Union replaces two windows, so it may carry one overhead's worth of extra pixels
+                if (lv_area_get_size(&joined) <=
+                    window_cost(&disp->inv_areas[i]) + lv_area_get_size(&disp->inv_areas[j])) {
+                    disp->inv_areas[i] = joined;
+                    disp->inv_area_joined[j] = 1;
+                    merged++;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    return merged;
+}
+
+static void refr_start_event_cb(lv_event_t *e) {
+    lv_display_t *disp = (lv_display_t*)lv_event_get_target(e);
+
+    // Layout runs after REFR_START and may invalidate more; settle it first
+    // so the merge sees the frame's final set of areas. Same screens as
+    // LVGL's own pass, including the outgoing one of a screen load animation
+    lv_obj_update_layout(disp->act_scr);
+    if (disp->prev_scr) lv_obj_update_layout(disp->prev_scr);
+    lv_obj_update_layout(disp->bottom_layer);
+    lv_obj_update_layout(disp->top_layer);
+    lv_obj_update_layout(disp->sys_layer);
+
+    uint32_t areas = 0;
+    for (uint32_t i = 0; i < disp->inv_p; i++) {
+        if (!disp->inv_area_joined[i]) areas++;
+    }
+
+    stats.frame_areas = areas;
+    stats.frame_merged = areas > 1 ? merge_invalid_areas(disp) : 0;
+    stats.frame_windows = 0;
+    stats.frame_transactions = 0;
+    stats.frame_yields = 0;
+}
+
+static void refr_ready_event_cb(lv_event_t *e) {
+    (void)e;
+    if (stats.frame_windows == 0) return;  // Nothing reached the panel
+
+    stats.frames++;
+    stats.total_areas += stats.frame_areas;
+    stats.total_merged += stats.frame_merged;
+    stats.total_windows += stats.frame_windows;
+    stats.total_transactions += stats.frame_transactions;
+    stats.total_yields += stats.frame_yields;
+
+    ESP_LOGV(TAG, "Frame: %lu areas, %lu merged, %lu windows, %lu transactions",
+             (unsigned long)stats.frame_areas, (unsigned long)stats.frame_merged,
+             (unsigned long)stats.frame_windows, (unsigned long)stats.frame_transactions);
+}
+
+void flush_scheduler_init(lv_display_t *disp) {
+    flush_scheduler_reset_stats();
+    lv_display_add_event_cb(disp, refr_start_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, refr_ready_event_cb, LV_EVENT_REFR_READY, NULL);
+    ESP_LOGI(TAG, "Flush scheduler enabled (window overhead: %d px)", FLUSH_WINDOW_OVERHEAD_PX);
+}
+
+void flush_scheduler_window_begin() {
+    if (!transaction_open) {
+        bus_arbiter_acquire(BUS_CLIENT_DISPLAY, UINT32_MAX);
+        gfx.startWrite();
+        transaction_open = true;
+        stats.frame_transactions++;
+    }
+    stats.frame_windows++;
+}
+
+void flush_scheduler_window_done(bool last) {
+    if (!transaction_open) return;
+
+    if (last) {
+        gfx.endWrite();
+        transaction_open = false;
+        bus_arbiter_release(BUS_CLIENT_DISPLAY);
+    } else if (bus_arbiter_contended(BUS_CLIENT_DISPLAY)) {
+        // The window is on the panel: close the transaction for one touch
+        // read, then carry on with the frame
+        gfx.endWrite();
+        if (bus_arbiter_yield(BUS_CLIENT_DISPLAY)) stats.frame_yields++;
+        gfx.startWrite();
+        stats.frame_transactions++;
+    }
+}
+
+void flush_scheduler_get_stats(flush_scheduler_stats_t *out) {
+    if (out) *out = stats;
+}
+
+void flush_scheduler_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+}
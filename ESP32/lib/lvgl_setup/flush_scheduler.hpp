@@ -0,0 +1,53 @@
+#ifndef FLUSH_SCHEDULER_HPP
+#define FLUSH_SCHEDULER_HPP
+
+#include <lvgl.h>
+
+/**
+ * Flush scheduler for the partial-render ILI9488 path
+ *
+ * - Merges invalidated areas at the start of each refresh when one larger
+ *   window is cheaper than several small ones (LVGL itself only joins areas
+ *   when the union is smaller than the sum, ignoring per-window overhead)
+ * - Batches all windows of a frame into one startWrite/endWrite transaction
+ * - Holds the shared SPI bus (bus_arbiter) for that transaction, handing
+ *   it to a waiting touch read between two windows; the transaction ends
+ *   with the frame (lvgl_flush_wait_idle() at REFR_READY in the DMA modes)
+ */
+
+// Fixed cost of one extra window in pixel equivalents: address window
+// commands, DMA setup and LVGL's per-area render pass (~150 us at 40 MHz)
+#ifndef FLUSH_WINDOW_OVERHEAD_PX
+#define FLUSH_WINDOW_OVERHEAD_PX 256
+#endif
+
+typedef struct {
+    // Last completed frame
+    uint32_t frame_areas;          // Invalidated areas before merging
+    uint32_t frame_merged;         // Areas folded into another by the scheduler
+    uint32_t frame_windows;        // Areas flushed (each may become several panel windows)
+    uint32_t frame_transactions;   // startWrite/endWrite pairs
+    uint32_t frame_yields;         // Bus slots given to touch between windows
+
+    // Totals since the last reset
+    uint32_t frames;
+    uint32_t total_areas;
+    uint32_t total_merged;
+    uint32_t total_windows;
+    uint32_t total_transactions;
+    uint32_t total_yields;
+} flush_scheduler_stats_t;
+
+// Hook the scheduler into the display's refresh events
+void flush_scheduler_init(lv_display_t *disp);
+
+// Call before writing each window; opens the frame transaction on first use
+void flush_scheduler_window_begin();
+
+// Call once a window's pixels are on the panel; closes the transaction after the last one
+void flush_scheduler_window_done(bool last);
+
+void flush_scheduler_get_stats(flush_scheduler_stats_t *stats);
+void flush_scheduler_reset_stats();
+
+#endif // FLUSH_SCHEDULER_HPP
@@ -0,0 +1,282 @@
+#include "input_record.hpp"
+#include "lvgl_setup.hpp"
+#include "touch_gesture.hpp"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* TAG = "INPUT_RECORD";
+
+#define FILE_MAGIC "LVIR"
+#define FILE_VERSION 1
+#define HEADER_BYTES 12
+#define EVENT_BYTES 6
+#define PRESSED_BIT 0x8000
+#define MAX_GAP_MS 0x7FFF
+
+typedef struct {
+    uint16_t dt_ms;
+    bool pressed;
+    int16_t x;
+    int16_t y;
+} event_t;
+
+static input_record_stats_t stats;
+
+// Recorder
+static uint8_t *rec_buf = NULL;
+static uint32_t rec_count = 0;
+static bool recording = false;
+static uint32_t rec_start_tick = 0;
+static uint32_t rec_last_tick = 0;
+static event_t rec_last;           // State LVGL saw last; released at (0, 0) before the first event
+
+// Replay
+static uint8_t *play_buf = NULL;
+static uint32_t play_count = 0;
+static uint32_t play_next = 0;
+static uint32_t play_start_tick = 0;
+static int64_t play_start_us = 0;
+static uint32_t play_event_ms = 0; // Recorded time of the current event
+static event_t play_current;
+static lv_indev_t *play_indev = NULL;
+static uint64_t late_sum_ms = 0;
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void encode(uint8_t *p, const event_t &e) {
+    put_u16(p, (uint16_t)(e.dt_ms | (e.pressed ? PRESSED_BIT : 0)));
+    put_u16(p + 2, (uint16_t)e.x);
+    put_u16(p + 4, (uint16_t)e.y);
+}
+
+static event_t decode(const uint8_t *p) {
+    event_t e;
+    uint16_t t = get_u16(p);
+    e.dt_ms = t & ~PRESSED_BIT;
+    e.pressed = (t & PRESSED_BIT) != 0;
+    e.x = (int16_t)get_u16(p + 2);
+    e.y = (int16_t)get_u16(p + 4);
+    return e;
+}
+
+static bool append(const event_t &e) {
+    if (rec_count == INPUT_RECORD_MAX_EVENTS) {
+        stats.dropped++;
+        return false;
+    }
+    encode(rec_buf + rec_count * EVENT_BYTES, e);
+    stats.recorded = ++rec_count;
+    return true;
+}
+
+bool input_record_start() {
+    if (rec_buf) input_record_stop(NULL);
+
+    rec_buf = (uint8_t*)malloc(INPUT_RECORD_MAX_EVENTS * EVENT_BYTES);
+    if (!rec_buf) {
+        ESP_LOGE(TAG, "No memory for %d events", INPUT_RECORD_MAX_EVENTS);
+        return false;
+    }
+    rec_count = 0;
+    rec_start_tick = lv_tick_get();
+    rec_last_tick = rec_start_tick;
+    rec_last = {0, false, 0, 0};
+    stats.recorded = 0;
+    stats.dropped = 0;
+    stats.record_ms = 0;
+    recording = true;
+
+    ESP_LOGI(TAG, "Recording touch input (up to %d events)", INPUT_RECORD_MAX_EVENTS);
+    return true;
+}
+
+void input_record_note(const lv_indev_data_t *data) {
+    if (!recording) return;
+
+    event_t e;
+    e.pressed = data->state == LV_INDEV_STATE_PR;
+    e.x = (int16_t)data->point.x;
+    e.y = (int16_t)data->point.y;
+    if (e.pressed == rec_last.pressed && e.x == rec_last.x && e.y == rec_last.y) return;
+
+    uint32_t now = lv_tick_get();
+    uint32_t dt = now - rec_last_tick;
+    while (dt > MAX_GAP_MS) {
+        rec_last.dt_ms = MAX_GAP_MS;
+        if (!append(rec_last)) return;
+        dt -= MAX_GAP_MS;
+    }
+    e.dt_ms = (uint16_t)dt;
+    if (!append(e)) return;
+
+    rec_last = e;
+    rec_last_tick = now;
+}
+
+bool input_record_is_active() {
+    return recording;
+}
+
+bool input_record_stop(const char *path) {
+    if (!rec_buf) return false;
+    recording = false;
+    stats.record_ms = lv_tick_elaps(rec_start_tick);
+
+    bool ok = true;
+    if (path) {
+        uint8_t header[HEADER_BYTES];
+        memcpy(header, FILE_MAGIC, 4);
+        put_u16(header + 4, FILE_VERSION);
+        put_u16(header + 6, 0);
+        put_u16(header + 8, (uint16_t)rec_count);
+        put_u16(header + 10, (uint16_t)(rec_count >> 16));
+
+        FILE *f = fopen(path, "wb");
+        ok = f && fwrite(header, 1, HEADER_BYTES, f) == HEADER_BYTES &&
+             fwrite(rec_buf, EVENT_BYTES, rec_count, f) == rec_count;
+        if (f && fclose(f) != 0) ok = false;
+
+        if (ok) {
+            ESP_LOGI(TAG, "Saved %lu events (%lu ms, %lu bytes) to %s", (unsigned long)rec_count,
+                     (unsigned long)stats.record_ms, (unsigned long)(HEADER_BYTES + rec_count * EVENT_BYTES), path);
+        } else {
+            ESP_LOGE(TAG, "Failed to write %s", path);
+        }
+    }
+    if (stats.dropped) {
+        ESP_LOGW(TAG, "%lu changes dropped, buffer full (INPUT_RECORD_MAX_EVENTS %d)",
+                 (unsigned long)stats.dropped, INPUT_RECORD_MAX_EVENTS);
+    }
+
+    free(rec_buf);
+    rec_buf = NULL;
+    return ok;
+}
+
+static void replay_finish() {
+    lv_indev_set_read_cb(play_indev, touch_read_callback);
+    free(play_buf);
+    play_buf = NULL;
+    play_indev = NULL;
+}
+
+// Stands in for touch_read_callback while a file plays
+static void replay_read_cb(lv_indev_t *indev, lv_indev_data_t *data) {
+    (void)indev;
+    uint32_t elapsed = lv_tick_elaps(play_start_tick);
+
+    if (play_next < play_count) {
+        event_t e = decode(play_buf + play_next * EVENT_BYTES);
+        if (play_event_ms + e.dt_ms <= elapsed) {
+            play_event_ms += e.dt_ms;
+            play_next++;
+
+            uint32_t late = elapsed - play_event_ms;
+            stats.replayed++;
+            late_sum_ms += late;
+            if (late > stats.late_max_ms) stats.late_max_ms = late;
+
+            // Gestures and the other hooks get the recorded timing, like
+            // samples from the sampler; a press that wakes the panel is dropped
+            touch_sample_t sample = {play_start_us + play_event_ms * 1000LL, e.x, e.y, e.pressed};
+            if (lvgl_touch_sample_accept(&sample)) {
+                play_current = e;
+                touch_gesture_feed(&sample);
+            }
+
+            // Points that fell due together reach LVGL one by one, as recorded
+            if (play_next < play_count) {
+                event_t following = decode(play_buf + play_next * EVENT_BYTES);
+                data->continue_reading = play_event_ms + following.dt_ms <= elapsed;
+            }
+        }
+    }
+
+    data->state = play_current.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+    data->point.x = play_current.x;
+    data->point.y = play_current.y;
+    input_record_note(data);
+    touch_gesture_tick(esp_timer_get_time());
+
+    if (play_next == play_count) {
+        ESP_LOGI(TAG, "Replay finished: %lu events, late by %lu ms max",
+                 (unsigned long)stats.replayed, (unsigned long)stats.late_max_ms);
+        replay_finish();
+    }
+}
+
+bool input_replay_start(lv_indev_t *indev, const char *path) {
+    if (!indev) return false;
+    if (play_buf) input_replay_stop();
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        ESP_LOGE(TAG, "Cannot open %s", path);
+        return false;
+    }
+
+    uint8_t header[HEADER_BYTES];
+    uint32_t count = 0;
+    bool ok = fread(header, 1, HEADER_BYTES, f) == HEADER_BYTES &&
+              memcmp(header, FILE_MAGIC, 4) == 0 && get_u16(header + 4) == FILE_VERSION;
+    if (ok) {
+        count = get_u16(header + 8) | ((uint32_t)get_u16(header + 10) << 16);
+        play_buf = (uint8_t*)malloc(count ? count * EVENT_BYTES : 1);
+        ok = play_buf && fread(play_buf, EVENT_BYTES, count, f) == count;
+    }
+    fclose(f);
+
+    if (!ok || count == 0) {
+        ESP_LOGE(TAG, "%s is not a valid recording", path);
+        free(play_buf);
+        play_buf = NULL;
+        return false;
+    }
+
+    play_count = count;
+    play_next = 0;
+    play_event_ms = 0;
+    play_current = {0, false, 0, 0};
+    play_indev = indev;
+    play_start_tick = lv_tick_get();
+    play_start_us = esp_timer_get_time();
+
+    stats.replayed = 0;
+    stats.late_max_ms = 0;
+    late_sum_ms = 0;
+    stats.replay_ms = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        stats.replay_ms += decode(play_buf + i * EVENT_BYTES).dt_ms;
+    }
+
+    lv_indev_set_read_cb(indev, replay_read_cb);
+    // Playback is polled; the touch read callback may have paused the reads
+    lv_timer_resume(lv_indev_get_read_timer(indev));
+    ESP_LOGI(TAG, "Replaying %lu events (%lu ms) from %s", (unsigned long)count,
+             (unsigned long)stats.replay_ms, path);
+    return true;
+}
+
+bool input_replay_is_active() {
+    return play_buf != NULL;
+}
+
+void input_replay_stop() {
+    if (play_buf) replay_finish();
+}
+
+void input_record_get_stats(input_record_stats_t *out) {
+    if (!out) return;
+    *out = stats;
+    out->late_avg_ms = stats.replayed ? (uint32_t)(late_sum_ms / stats.replayed) : 0;
+}
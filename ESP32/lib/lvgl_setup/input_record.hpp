@@ -0,0 +1,84 @@
+#ifndef INPUT_RECORD_HPP
+#define INPUT_RECORD_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+
+/**
+ * Touch input record and replay
+ *
+ * The recorder captures what touch_read_callback hands LVGL (state, x, y)
+ * with the LVGL tick, keeping only changes, into RAM; input_record_stop()
+ * saves it as a compact binary file (SPIFFS on the device, any path on the
+ * host). The replay driver swaps the pointer's read callback for one that
+ * plays a file back on the recorded timeline, so a session recorded once by
+ * hand can drive any build the same way.
+ *
+ * File format (little-endian):
+ *   header  "LVIR", uint16 version, uint16 reserved, uint32 event count
+ *   event   uint16 time since the previous event in ms (bit 15: pressed),
+ *           int16 x, int16 y
+ * Gaps longer than 32.767 s are split by repeating the previous point.
+ *
+ * Points reach LVGL at its next read after their time, so replay is exact
+ * to one indev read period; stats report how late each point was.
+ */
+
+// What the firmware does at boot, selected with -D INPUT_RECORD_MODE=<value>
+#define INPUT_RECORD_OFF     0
+#define INPUT_RECORD_CAPTURE 1  // Record the first INPUT_RECORD_SECONDS, then save to INPUT_RECORD_PATH
+#define INPUT_RECORD_REPLAY  2  // Play INPUT_RECORD_PATH back instead of the touch panel
+
+#ifndef INPUT_RECORD_MODE
+#define INPUT_RECORD_MODE INPUT_RECORD_OFF
+#endif
+
+#ifndef INPUT_RECORD_PATH
+#define INPUT_RECORD_PATH "/spiffs/input.lvir"
+#endif
+
+#ifndef INPUT_RECORD_SECONDS
+#define INPUT_RECORD_SECONDS 60
+#endif
+
+// Recording buffer (6 bytes per event, allocated only while recording)
+#ifndef INPUT_RECORD_MAX_EVENTS
+#define INPUT_RECORD_MAX_EVENTS 4096
+#endif
+
+typedef struct {
+    uint32_t recorded;         // Events captured
+    uint32_t dropped;          // Changes lost to a full buffer
+    uint32_t record_ms;        // Length of the recording
+    uint32_t replayed;         // Events handed to LVGL
+    uint32_t replay_ms;        // Length of the loaded file
+    uint32_t late_max_ms;      // Worst delay of a replayed event behind its recorded time
+    uint32_t late_avg_ms;
+} input_record_stats_t;
+
+// Start capturing (LVGL task); drops a previous unsaved recording
+bool input_record_start();
+
+// Feed what the read callback reports to LVGL; no-op unless recording
+void input_record_note(const lv_indev_data_t *data);
+
+bool input_record_is_active();
+
+// Stop capturing and write the file (NULL only discards); false on I/O error
+bool input_record_stop(const char *path);
+
+/**
+ * Play path back through indev (LVGL task)
+ *
+ * The file is loaded into RAM and indev's read callback replaced until the
+ * last event was played, then restored.
+ */
+bool input_replay_start(lv_indev_t *indev, const char *path);
+
+// True until the last event was played or input_replay_stop()
+bool input_replay_is_active();
+void input_replay_stop();
+
+void input_record_get_stats(input_record_stats_t *stats);
+
+#endif // INPUT_RECORD_HPP
@@ -2,77 +2,299 @@
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "display.hpp"
+#include "flush_scheduler.hpp"
+#include "flush_pipeline.hpp"
+#include "bus_arbiter.hpp"
+#include "shadow_fb.hpp"
+#include "pixel_convert.hpp"
+#include "draw_buffers.hpp"
+#include "touch_sampler.hpp"
+#include "touch_filter.hpp"
+#include "touch_predict.hpp"
+#include "touch_latency.hpp"
+#include "input_record.hpp"
+#include "touch_gesture.hpp"
+#include "lvgl_task.hpp"
+#include "power_manager.hpp"
+#include "refresh_governor.hpp"
+#include "perf_metrics.hpp"
 
 static const char* TAG = "LVGL";
 
 lv_display_t *disp;
 lv_indev_t *indev;
-static lv_color_t *draw_buf1;
-static lv_color_t *draw_buf2;
 
-// LVGL tick task callback
-void lv_tick_task(void *arg) {
-    (void)arg;
-    lv_tick_inc(LV_TICK_PERIOD_MS);
+// LVGL tick source: read from the microsecond clock when LVGL asks, so no
+// timer interrupt keeps running just to count milliseconds (the simulated
+// clock in the native build)
+static uint32_t lvgl_tick_cb() {
+    return (uint32_t)(esp_timer_get_time() / 1000);
 }
 
+#if LVGL_FLUSH_MODE == LVGL_FLUSH_ASYNC
+// Display whose buffer is currently on the wire (NULL when the bus is idle)
+static lv_display_t *flush_in_flight = NULL;
+static bool flush_in_flight_last = false;
+
+// Time the flush callback spent queueing the buffer (PERF_FLUSH adds the
+// wait for the DMA; the time LVGL spent rendering in between is not flush)
+static uint32_t flush_queue_us = 0;
+#endif
+
+// Transfer-complete path: release the bus and hand the buffer back to LVGL
+void lvgl_flush_wait_idle() {
+#if LVGL_FLUSH_MODE == LVGL_FLUSH_ASYNC
+    if (!flush_in_flight) return;
+
+    lv_display_t *flushed = flush_in_flight;
+    flush_in_flight = NULL;
+    int64_t wait_start = perf_metrics_now_us();
+    gfx.waitDMA();
+    uint32_t waited_us = (uint32_t)(perf_metrics_now_us() - wait_start);
+    draw_buffers_note_stall(waited_us);
+    flush_scheduler_window_done(flush_in_flight_last);
+    perf_metrics_record(PERF_FLUSH, flush_queue_us + waited_us);
+    touch_latency_flush_ready();
+    lv_display_flush_ready(flushed);
+#elif LVGL_FLUSH_MODE == LVGL_FLUSH_PIPELINE
+    // The job may be long done (always in the native build); the buffer is
+    // still LVGL's to take back
+    if (!flush_pipeline_outstanding()) return;
+
+    int64_t wait_start = esp_timer_get_time();
+    int64_t done_us = flush_pipeline_wait();
+    draw_buffers_note_stall((uint32_t)(esp_timer_get_time() - wait_start));
+    touch_latency_flush_done(done_us);
+    lv_display_flush_ready(disp);
+#endif
+}
+
+#if LVGL_FLUSH_MODE != LVGL_FLUSH_BLOCKING
+// Called by LVGL when it needs the in-flight buffer back within a frame, so
+// rendering into the other buffer overlaps the SPI transfer
+static void lovyangfx_flush_wait_cb(lv_display_t *disp_drv) {
+    (void)disp_drv;
+    lvgl_flush_wait_idle();
+}
+#endif
+
+#if LVGL_FLUSH_MODE != LVGL_FLUSH_BLOCKING
+// LVGL only asks for the frame's last buffer when the next frame needs it,
+// which on a still screen can be a second away. Wait for it here instead:
+// the frame's transaction closes and the bus is released with the frame,
+// and the flush is completed when it is on the panel, not when the buffer
+// is reused. The pipeline's flush task also owns the shadow until then.
+static void flush_refr_ready_event_cb(lv_event_t *e) {
+    (void)e;
+    lvgl_flush_wait_idle();
+}
+#endif
+
+/**
+ * Locate the pixels of one flush for the shadow/encoder chain
+ *
+ * In FULL render mode the area is the whole screen: LVGL 9 invalidates all
+ * of it every frame, so only the shadow (shadow_fb.hpp) can trim it down to
+ * what changed. DIRECT mode flushes each dirty area out of the framebuffer.
+ */
+static flush_write_t plan_flush(lv_display_t *disp_drv, const lv_area_t *area, const flush_px_t *px) {
+    if (draw_buffers_get_render_mode() == LV_DISPLAY_RENDER_MODE_DIRECT) {
+        // px is the framebuffer, area is in screen coordinates
+        int32_t stride = lv_display_get_horizontal_resolution(disp_drv);
+        return {*area, px + area->y1 * stride + area->x1, stride};
+    }
+    return {*area, px, lv_area_get_width(area)};
+}
+
+#if LVGL_FLUSH_MODE != LVGL_FLUSH_PIPELINE
+// Pass the pixels of one flush through the shadow/encoder chain
+static void write_flush(lv_display_t *disp_drv, const lv_area_t *area, const flush_px_t *px, bool use_dma) {
+    flush_write_t w = plan_flush(disp_drv, area, px);
+    perf_metrics_note_flush(lv_area_get_size(&w.area));
+    shadow_fb_write(&w.area, w.px, w.stride, use_dma);
+}
+#endif
+
 // LovyanGFX display flush callback
 void lovyangfx_flush_cb(lv_display_t *disp_drv, const lv_area_t *area, uint8_t *px_map) {
-    uint32_t w = (area->x2 - area->x1 + 1);
-    uint32_t h = (area->y2 - area->y1 + 1);
+    bool last = lv_display_flush_is_last(disp_drv);
+
+    draw_buffers_note_flush(lv_area_get_size(area));
+
+#if LVGL_FLUSH_MODE == LVGL_FLUSH_PIPELINE
+    touch_latency_flush_start(area);
+
+    // The flush task opens the frame transaction and writes the job
+    flush_job_t job;
+    job.write = plan_flush(disp_drv, area, (const flush_px_t*)px_map);
+    perf_metrics_note_flush(lv_area_get_size(&job.write.area));
+    job.last = last;
+    flush_pipeline_submit(&job);
+#else
+    int64_t flush_start_us = perf_metrics_now_us();
 
-    gfx.startWrite();
-    gfx.setAddrWindow(area->x1, area->y1, w, h);
-    gfx.writePixels((lgfx::rgb565_t*)px_map, w * h);
-    gfx.endWrite();
+    // All windows of a frame share one transaction
+    flush_scheduler_window_begin();
+    touch_latency_flush_start(area);
 
+#if LVGL_FLUSH_MODE == LVGL_FLUSH_ASYNC
+    // LVGL waits for the previous buffer before flushing, so at most one
+    // transfer is queued
+    write_flush(disp_drv, area, (const flush_px_t*)px_map, true);
+    flush_queue_us = (uint32_t)(perf_metrics_now_us() - flush_start_us);
+    flush_in_flight = disp_drv;
+    flush_in_flight_last = last;
+#else
+    int64_t write_start = esp_timer_get_time();
+    write_flush(disp_drv, area, (const flush_px_t*)px_map, false);
+    flush_scheduler_window_done(last);
+    draw_buffers_note_stall((uint32_t)(esp_timer_get_time() - write_start));
+    perf_metrics_record(PERF_FLUSH, (uint32_t)(perf_metrics_now_us() - flush_start_us));
+
+    touch_latency_flush_ready();
     lv_display_flush_ready(disp_drv);
+#endif
+#endif
+}
+
+// LVGL touch input callback: drains the samples taken by the touch sampler
+bool lvgl_touch_sample_accept(const touch_sample_t *sample) {
+    // The press that wakes a dark panel never reaches LVGL (power_manager.hpp)
+    if (power_manager_touch(sample)) return false;
+    // Whatever the finger does next is drawn at the full rate
+    refresh_governor_boost();
+    // Clicks dispatched for this point are timed from when it was sampled
+    touch_latency_note_sample(sample);
+    return true;
 }
 
-// LVGL touch input callback
 void touch_read_callback(lv_indev_t *indev_driver, lv_indev_data_t *data) {
-    static bool was_pressed = false;
-    uint16_t touch_x, touch_y;
-    bool touched = gfx.getTouch(&touch_x, &touch_y);
+    static touch_sample_t last = {0, 0, 0, false};
+    touch_sample_t sample;
 
-    if (!touched) {
-        if (was_pressed) {
+#if !TOUCH_SAMPLER_TASK
+    touch_sampler_poll();
+#endif
+
+    bool popped = touch_sampler_pop(&sample);
+    while (popped && !lvgl_touch_sample_accept(&sample)) {
+        popped = touch_sampler_pop(&sample);
+    }
+    if (popped) {
+#if TOUCH_TRACE_LOG
+        // Raw samples in the trace format of the native filter benchmark
+        ESP_LOGI(TAG, "TRACE,%lu,%d,%d,%d", (unsigned long)(sample.time_us / 1000),
+                 sample.pressed, sample.x, sample.y);
+#endif
+        touch_filter_apply(&sample);
+        // Gestures see the finger, not the prediction
+        touch_gesture_feed(&sample);
+        // Only drags that LVGL turned into a scroll are worth predicting
+        touch_predict_apply(&sample, lv_indev_get_scroll_obj(indev_driver) != NULL);
+        if (sample.pressed && !last.pressed) {
+            ESP_LOGI(TAG, "Touch PRESSED at x=%d, y=%d", sample.x, sample.y);
+        } else if (!sample.pressed && last.pressed) {
             ESP_LOGI(TAG, "Touch RELEASED");
-            was_pressed = false;
-        }
-        data->state = LV_INDEV_STATE_REL;
-    } else {
-        if (!was_pressed) {
-            ESP_LOGI(TAG, "Touch PRESSED at x=%d, y=%d (settings area: 10-55, 430-475)", touch_x, touch_y);
-            was_pressed = true;
         }
-        data->state = LV_INDEV_STATE_PR;
-        data->point.x = touch_x;
-        data->point.y = touch_y;
+        last = sample;
+        // Hand LVGL every queued point, not just the newest
+        data->continue_reading = touch_sampler_pending();
     }
+
+    data->state = last.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+    data->point.x = last.x;
+    data->point.y = last.y;
+    input_record_note(data);
+    touch_gesture_tick(esp_timer_get_time());
+
+#if TOUCH_SAMPLER_TASK
+    // Nothing to read until the sampler wakes the LVGL task (lvgl_task.hpp);
+    // a scroll still coasting after the release needs the reads to go on
+    if (!last.pressed && !data->continue_reading && !lv_indev_get_scroll_obj(indev_driver)) {
+        lv_timer_pause(lv_indev_get_read_timer(indev_driver));
+    }
+#endif
 }
 
-void init_lvgl_display() {
-    ESP_LOGI(TAG, "Initializing LVGL display...");
-    lv_init();
+void lvgl_set_rotation(uint8_t rotation) {
+    if (!disp || gfx.getRotation() == rotation) return;
 
-    // Create display buffer for LovyanGFX
-    uint32_t buf_size = TFT_HOR_RES * TFT_VER_RES / 10;  // 1/10 screen buffer
-    draw_buf1 = (lv_color_t*)heap_caps_malloc(buf_size * sizeof(lv_color_t), MALLOC_CAP_DMA);
-    draw_buf2 = (lv_color_t*)heap_caps_malloc(buf_size * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    // The scan direction must not change under a transfer
+    lvgl_flush_wait_idle();
+    bus_arbiter_acquire(BUS_CLIENT_DISPLAY, UINT32_MAX);  // Touch mapping changes too
+    gfx.setRotation(rotation);
+    bus_arbiter_release(BUS_CLIENT_DISPLAY);
 
-    if (!draw_buf1 || !draw_buf2) {
-        ESP_LOGE(TAG, "Failed to allocate display buffers");
-        return;
+    // Resizes the screens (the tabview and widgets relayout) and invalidates them
+    lv_display_set_resolution(disp, gfx.width(), gfx.height());
+    draw_buffers_update_resolution();
+    shadow_fb_set_resolution(gfx.width(), gfx.height());
+
+    ESP_LOGI(TAG, "Rotation %d: %dx%d", rotation, (int)gfx.width(), (int)gfx.height());
+}
+
+// SPI bus contention between display and touch since the last report
+static void report_bus() {
+    for (int c = 0; c < BUS_CLIENT_COUNT; c++) {
+        bus_client_stats_t bus;
+        bus_arbiter_get_stats((bus_client_t)c, &bus);
+        ESP_LOGI(TAG, "BUS %s - held: %llu ms, waited: %llu ms (max %lu us), transactions: %lu, slots: %lu, timeouts: %lu",
+                 bus_arbiter_client_name((bus_client_t)c),
+                 (unsigned long long)(bus.busy_us / 1000), (unsigned long long)(bus.wait_us / 1000), (unsigned long)bus.max_wait_us,
+                 (unsigned long)bus.transactions, (unsigned long)bus.yields, (unsigned long)bus.timeouts);
+    }
+    bus_arbiter_reset_stats();
+}
+
+// Scroll prediction error against the lag it removes since the last report
+static void report_predict() {
+    touch_predict_stats_t predict;
+    touch_predict_get_stats(&predict);
+    if (predict.evaluated > 0) {
+        ESP_LOGI(TAG, "PREDICT - error: %.1f px avg (max %.1f) vs %.1f px lag unpredicted, %lu points moved, %lu too slow",
+                 predict.err_avg_px, predict.err_max_px, predict.lag_avg_px,
+                 (unsigned long)predict.predicted, (unsigned long)predict.slow);
     }
+    touch_predict_reset_stats();
+}
+
+void init_lvgl_display() {
+    ESP_LOGI(TAG, "Initializing LVGL display...");
+    lv_init();
+    lv_tick_set_cb(lvgl_tick_cb);
 
     // Create LVGL display
-    disp = lv_display_create(TFT_HOR_RES, TFT_VER_RES);
+    // Sized for the orientation init_display() put the panel in
+    disp = lv_display_create(gfx.width(), gfx.height());
     lv_display_set_flush_cb(disp, lovyangfx_flush_cb);
-    lv_display_set_buffers(disp, draw_buf1, draw_buf2, buf_size, LV_DISPLAY_RENDER_MODE_PARTIAL);
-    lv_display_set_rotation(disp, LV_DISPLAY_ROTATION_0);  // Portrait mode
+#if LVGL_FLUSH_MODE != LVGL_FLUSH_BLOCKING
+    lv_display_set_flush_wait_cb(disp, lovyangfx_flush_wait_cb);
+    // Before every other REFR_READY handler, so they see the whole frame on the panel
+    lv_display_add_event_cb(disp, flush_refr_ready_event_cb, LV_EVENT_REFR_READY, NULL);
+#endif
+#if LVGL_FLUSH_MODE == LVGL_FLUSH_PIPELINE
+    if (!flush_pipeline_init()) {
+        lv_display_delete(disp);
+        disp = NULL;
+        return;
+    }
+#endif
+    if (!draw_buffers_init(disp)) {
+        lv_display_delete(disp);
+        disp = NULL;
+        return;
+    }
+    lv_display_set_rotation(disp, LV_DISPLAY_ROTATION_0);  // Rotation is done by the panel, see lvgl_set_rotation()
+    flush_scheduler_init(disp);
+    perf_metrics_init(disp);
+    perf_metrics_add_report(report_bus);
+    refresh_governor_init(disp);
+    pixel_convert_init();
+    shadow_fb_init(gfx.width(), gfx.height());
 
-    ESP_LOGI(TAG, "LVGL display created with LovyanGFX integration");
+    ESP_LOGI(TAG, "LVGL display created with LovyanGFX integration (%s flush)",
+             LVGL_FLUSH_MODE == LVGL_FLUSH_PIPELINE ? "two-core pipeline" :
+             LVGL_FLUSH_MODE == LVGL_FLUSH_ASYNC ? "async DMA" : "blocking");
 }
 
 void init_lvgl_input_device() {
@@ -81,18 +303,10 @@ void init_lvgl_input_device() {
     lv_indev_set_type(indev, LV_INDEV_TYPE_POINTER);
     lv_indev_set_read_cb(indev, touch_read_callback);
     lv_indev_enable(indev, true);
+    touch_filter_init();
+    touch_latency_init();
+    perf_metrics_add_report(report_predict);
+    touch_gesture_init();
+    touch_sampler_init();
     ESP_LOGI(TAG, "LVGL input device created and enabled");
 }
-
-void init_lvgl_timer() {
-    ESP_LOGI(TAG, "Initializing LVGL timer...");
-    // Create and start a periodic timer for LVGL tick
-    const esp_timer_create_args_t periodic_timer_args = {
-        .callback = &lv_tick_task,
-        .name = "periodic_gui"
-    };
-    esp_timer_handle_t periodic_timer;
-    ESP_ERROR_CHECK(esp_timer_create(&periodic_timer_args, &periodic_timer));
-    ESP_ERROR_CHECK(esp_timer_start_periodic(periodic_timer, LV_TICK_PERIOD_MS * 1000));
-    ESP_LOGI(TAG, "LVGL timer started");
-}
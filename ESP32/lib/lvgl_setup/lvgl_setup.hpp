@@ -2,19 +2,54 @@
 #define LVGL_SETUP_HPP
 
 #include <lvgl.h>
+#include "touch_sampler.hpp"
 
-#define DRAW_BUF_SIZE (320 * 480 / 5 * (LV_COLOR_DEPTH / 8))  // Increased from /10 to /5 for better FPS
-#define LV_TICK_PERIOD_MS 5    // Optimized from 2ms to 5ms for better performance
-#define TASK_SLEEP_PERIOD_MS 5 // Optimized from 10ms to 5ms for better responsivity
+// Flush strategies, selected at build time with -D LVGL_FLUSH_MODE=<value>
+#define LVGL_FLUSH_BLOCKING 0  // Wait for the transfer inside the flush callback
+#define LVGL_FLUSH_ASYNC    1  // Queue to DMA, flush-ready when LVGL needs the buffer or the frame ends
+#define LVGL_FLUSH_PIPELINE 2  // Convert and transfer in a flush task on the other core (flush_pipeline.hpp)
+
+#ifndef LVGL_FLUSH_MODE
+#define LVGL_FLUSH_MODE LVGL_FLUSH_ASYNC
+#endif
+
+// Render modes, selected at build time with -D LVGL_RENDER_MODE=<value>
+#define LVGL_RENDER_PARTIAL 0  // Draw buffers of a few dozen lines, areas rendered in bands
+#define LVGL_RENDER_DIRECT  1  // Full-screen framebuffer, each dirty area flushed as rendered
+#define LVGL_RENDER_FULL    2  // Full-screen framebuffer, the whole screen flushed every frame
+
+#ifndef LVGL_RENDER_MODE
+#define LVGL_RENDER_MODE LVGL_RENDER_PARTIAL
+#endif
+
+// Log every raw touch sample as "TRACE,t_ms,pressed,x,y" (input for --bench-touch-filter)
+#ifndef TOUCH_TRACE_LOG
+#define TOUCH_TRACE_LOG 0
+#endif
 
 // Initialize LVGL components
 void init_lvgl_display();
 void init_lvgl_input_device();
-void init_lvgl_timer();
 
 // Touch callback
 void touch_read_callback(lv_indev_t *indev_driver, lv_indev_data_t *data);
 
+// Power, refresh-rate and latency hooks every touch point goes through before
+// LVGL sees it, live or replayed; false if it must not reach LVGL
+bool lvgl_touch_sample_accept(const touch_sample_t *sample);
+
+/**
+ * Switch the panel orientation at runtime (LovyanGFX rotation, 0-3)
+ *
+ * The panel's scan direction changes, so pixels keep streaming straight
+ * through without an LVGL software rotation. Screens are resized and relaid
+ * out in place. Call from the LVGL task, outside a refresh.
+ */
+void lvgl_set_rotation(uint8_t rotation);
+
+// Complete any in-flight display transfer (call before other users of the SPI bus)
+void lvgl_flush_wait_idle();
+
 // Get global LVGL objects
 extern lv_display_t *disp;
 extern lv_indev_t *indev;
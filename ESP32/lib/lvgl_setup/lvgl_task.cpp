@@ -0,0 +1,111 @@
+#include "lvgl_task.hpp"
+#include "lvgl_setup.hpp"
+#include "power_manager.hpp"
+#include "perf_metrics.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+
+#ifndef NATIVE_BUILD
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+static const char* TAG = "LVGL_TASK";
+
+static lvgl_task_stats_t stats;
+static int64_t stats_since_us = 0;
+
+#ifdef NATIVE_BUILD
+// Reasons handled since the last wait; they ended that wait on the device
+static uint32_t host_reasons = 0;
+#else
+static TaskHandle_t lvgl_task = NULL;
+#endif
+
+// LVGL task: make LVGL look at what woke it before the next lv_timer_handler()
+static void handle_wake(uint32_t reasons) {
+    if (reasons & LVGL_TASK_WAKE_TOUCH) stats.touch_wakeups++;
+    if (reasons & LVGL_TASK_WAKE_APP) stats.app_wakeups++;
+
+    if ((reasons & LVGL_TASK_WAKE_TOUCH) && indev) {
+        // The read callback paused the read timer when the pen went up
+        lv_lock();
+        lv_timer_t *read_timer = lv_indev_get_read_timer(indev);
+        lv_timer_resume(read_timer);
+        lv_timer_ready(read_timer);
+        lv_unlock();
+    }
+}
+
+// How often LVGL woke since the last report, and why
+static void report() {
+    lvgl_task_stats_t task;
+    lvgl_task_get_stats(&task);
+    ESP_LOGI(TAG, "LVGL TASK - %lu wakeups (timer %lu, touch %lu, app %lu), slept %llu%%",
+             (unsigned long)task.wakeups, (unsigned long)task.timer_wakeups,
+             (unsigned long)task.touch_wakeups, (unsigned long)task.app_wakeups,
+             (unsigned long long)(task.elapsed_us ? task.slept_us * 100 / task.elapsed_us : 0));
+    lvgl_task_reset_stats();
+}
+
+void lvgl_task_init() {
+#ifndef NATIVE_BUILD
+    lvgl_task = xTaskGetCurrentTaskHandle();
+#endif
+    lvgl_task_reset_stats();
+    perf_metrics_add_report(report);
+    ESP_LOGI(TAG, "LVGL runs event-driven, sleeping %d-%d ms between timers",
+             LVGL_TASK_MIN_SLEEP_MS, LVGL_TASK_MAX_SLEEP_MS);
+}
+
+uint32_t lvgl_task_wait(uint32_t next_ms) {
+    // LV_NO_TIMER_READY (every timer paused) is far above the maximum
+    uint32_t sleep_ms = next_ms;
+    if (sleep_ms < LVGL_TASK_MIN_SLEEP_MS) sleep_ms = LVGL_TASK_MIN_SLEEP_MS;
+    if (sleep_ms > LVGL_TASK_MAX_SLEEP_MS) sleep_ms = LVGL_TASK_MAX_SLEEP_MS;
+
+    uint32_t reasons = 0;
+    int64_t start = esp_timer_get_time();
+    // In the idle states part or all of the wait is a light sleep
+    uint32_t wait_ms = power_manager_light_sleep(sleep_ms);
+#ifdef NATIVE_BUILD
+    // Wakes were handled when they were sent
+    esp_timer_host_advance((uint64_t)wait_ms * 1000);
+#else
+    // Clear all bits on exit; a wake sent while LVGL ran ends this wait at once
+    xTaskNotifyWait(0, UINT32_MAX, &reasons, pdMS_TO_TICKS(wait_ms));
+#endif
+    stats.slept_us += (uint64_t)(esp_timer_get_time() - start);
+
+    stats.wakeups++;
+#ifdef NATIVE_BUILD
+    if (host_reasons == 0) stats.timer_wakeups++;
+    host_reasons = 0;
+#else
+    if (reasons == 0) stats.timer_wakeups++;
+    handle_wake(reasons);
+#endif
+    return reasons;
+}
+
+void lvgl_task_wake(uint32_t reasons) {
+#ifdef NATIVE_BUILD
+    // Single thread: the caller is the LVGL task
+    host_reasons |= reasons;
+    handle_wake(reasons);
+#else
+    if (lvgl_task) xTaskNotify(lvgl_task, reasons, eSetBits);
+#endif
+}
+
+void lvgl_task_get_stats(lvgl_task_stats_t *out) {
+    if (!out) return;
+    *out = stats;
+    out->elapsed_us = (uint64_t)(esp_timer_get_time() - stats_since_us);
+}
+
+void lvgl_task_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+    stats_since_us = esp_timer_get_time();
+}
@@ -0,0 +1,65 @@
+#ifndef LVGL_TASK_HPP
+#define LVGL_TASK_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+
+/**
+ * Event-driven LVGL runner
+ *
+ * The task that calls lv_timer_handler() sleeps exactly until LVGL's next
+ * timer is due (the handler's return value) instead of a fixed period, and
+ * is woken early by a task notification when something happens that LVGL
+ * has to see now: a new touch sample, or work queued by another task.
+ *
+ * With the touch sampling task, the indev read timer is paused while the
+ * pen is up and nothing scrolls, and a touch wake resumes it and reads at
+ * once. An idle screen then only wakes for timers that really have work
+ * (animations, the display refresh while something is invalid, app timers).
+ * Once the power manager has stepped down, the wait is a light sleep that
+ * the touch interrupt ends (power_manager.hpp).
+ *
+ * In the native build there is one thread: a wake is handled on the spot
+ * and lvgl_task_wait() advances the simulated clock instead of sleeping.
+ */
+
+// Never sleep shorter (keeps a busy handler from starving lower priorities)
+#ifndef LVGL_TASK_MIN_SLEEP_MS
+#define LVGL_TASK_MIN_SLEEP_MS 1
+#endif
+
+// Never sleep longer, so the caller's own bookkeeping still runs when LVGL is idle
+#ifndef LVGL_TASK_MAX_SLEEP_MS
+#define LVGL_TASK_MAX_SLEEP_MS 1000
+#endif
+
+// Wake reasons (notification bits, may be combined)
+#define LVGL_TASK_WAKE_TOUCH (1u << 0)  // A touch sample is waiting
+#define LVGL_TASK_WAKE_APP   (1u << 1)  // Another task queued work for the UI
+
+typedef struct {
+    uint32_t wakeups;          // Sleeps that ended, for any reason
+    uint32_t timer_wakeups;    // Ended because an LVGL timer was due
+    uint32_t touch_wakeups;
+    uint32_t app_wakeups;
+    uint64_t slept_us;         // Time spent waiting
+    uint64_t elapsed_us;       // Since the last reset
+} lvgl_task_stats_t;
+
+// Bind the calling task as the one that runs LVGL (call before the other init_lvgl_* functions)
+void lvgl_task_init();
+
+/**
+ * Sleep until next_ms (lv_timer_handler()'s return value) passes or a wake
+ * arrives, then prepare LVGL for the wake. Returns the wake reasons, 0 when
+ * the sleep ran out.
+ */
+uint32_t lvgl_task_wait(uint32_t next_ms);
+
+// Wake the LVGL task early (any task)
+void lvgl_task_wake(uint32_t reasons);
+
+void lvgl_task_get_stats(lvgl_task_stats_t *stats);
+void lvgl_task_reset_stats();
+
+#endif // LVGL_TASK_HPP
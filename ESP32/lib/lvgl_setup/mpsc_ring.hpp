@@ -0,0 +1,79 @@
+#ifndef MPSC_RING_HPP
+#define MPSC_RING_HPP
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * Lock-free multi-producer / single-consumer ring
+ *
+ * Any number of tasks push, one task pops; nobody blocks or disables
+ * interrupts. Each slot carries a sequence number: a producer claims a
+ * position with one compare-and-swap on head, writes the slot and
+ * publishes it by storing the sequence (release). The consumer reads a
+ * slot once its sequence says it is published (acquire) and hands it back
+ * to the producers one lap later. Capacity is N entries, N must be a power
+ * of two.
+ *
+ * A producer preempted between claim and publish holds up the consumer
+ * at that slot until it runs again; later slots are not skipped, so items
+ * always come out in claim order.
+ */
+template <typename T, uint32_t N>
+class mpsc_ring {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "mpsc_ring size must be a power of two");
+
+    struct slot_t {
+        std::atomic<uint32_t> seq;
+        T item;
+    };
+
+    slot_t slots[N];
+    std::atomic<uint32_t> head{0};  // Next position to claim, all producers
+    uint32_t tail = 0;              // Next position to read, consumer only
+
+public:
+    mpsc_ring() {
+        for (uint32_t i = 0; i < N; i++) {
+            slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Producer side, any task; false when full (the item is dropped)
+    bool push(const T &item) {
+        uint32_t pos = head.load(std::memory_order_relaxed);
+        for (;;) {
+            slot_t &s = slots[pos & (N - 1)];
+            int32_t diff = (int32_t)(s.seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                // Free for this lap; on failure pos holds the new head
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    s.item = item;
+                    s.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;  // The consumer has not freed it yet: full
+            } else {
+                pos = head.load(std::memory_order_relaxed);  // Another producer took it
+            }
+        }
+    }
+
+    // Consumer side; false when empty or the next item is not published yet
+    bool pop(T *item) {
+        slot_t &s = slots[tail & (N - 1)];
+        if (s.seq.load(std::memory_order_acquire) != tail + 1) return false;
+        *item = s.item;
+        s.seq.store(tail + N, std::memory_order_release);
+        tail++;
+        return true;
+    }
+
+    // Consumer side
+    bool empty() const {
+        return slots[tail & (N - 1)].seq.load(std::memory_order_acquire) != tail + 1;
+    }
+};
+
+#endif // MPSC_RING_HPP
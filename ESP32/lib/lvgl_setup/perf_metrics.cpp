@@ -0,0 +1,266 @@
+#include "perf_metrics.hpp"
+#include "flush_scheduler.hpp"
+#include "refresh_governor.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <atomic>
+#include <string.h>
+
+#ifdef NATIVE_BUILD
+#include <chrono>
+#define IRAM_ATTR
+#else
+#include <esp_attr.h>
+#endif
+
+static const char* TAG = "PERF";
+
+static const char* const metric_names[PERF_METRIC_COUNT] = {
+    "render", "flush", "input_latency", "timer_handler", "refresh_jitter"
+};
+
+typedef struct {
+    std::atomic<uint32_t> buckets[PERF_HIST_BUCKETS];
+    std::atomic<uint32_t> max_us;
+} histogram_t;
+
+static histogram_t hist[PERF_METRIC_COUNT];
+
+// Refresh being timed (LVGL task only)
+static int64_t refr_start_us = 0;
+static uint32_t refr_start_frames = 0;
+static int64_t last_refr_tick_us = 0;   // Previous refresh on the esp_timer clock
+static uint32_t frame_px = 0;           // Flushed by the refresh in progress
+
+static perf_frame_counters_t counters;
+static perf_frame_counters_t report_frames;   // At the last report
+
+static perf_report_cb_t reports[PERF_REPORTS_MAX];
+static uint32_t report_count = 0;
+
+static uint32_t IRAM_ATTR bucket_index(uint32_t us) {
+    if (us > PERF_HIST_MAX_US) us = PERF_HIST_MAX_US;
+    if (us < 2 * PERF_HIST_SUB_BUCKETS) return us;
+    // Above the linear range: the top bits pick the power of two, the next ones the sub-bucket
+    uint32_t shift = 31 - __builtin_clz(us) - PERF_HIST_SUB_BITS;
+    return shift * PERF_HIST_SUB_BUCKETS + (us >> shift);
+}
+
+uint32_t perf_metrics_bucket_lower_us(uint32_t bucket) {
+    if (bucket < 2 * PERF_HIST_SUB_BUCKETS) return bucket;
+    uint32_t shift = bucket / PERF_HIST_SUB_BUCKETS - 1;
+    return (bucket % PERF_HIST_SUB_BUCKETS + PERF_HIST_SUB_BUCKETS) << shift;
+}
+
+uint32_t perf_metrics_bucket_upper_us(uint32_t bucket) {
+    if (bucket < 2 * PERF_HIST_SUB_BUCKETS) return bucket;
+    uint32_t shift = bucket / PERF_HIST_SUB_BUCKETS - 1;
+    return perf_metrics_bucket_lower_us(bucket) + (1UL << shift) - 1;
+}
+
+int64_t perf_metrics_now_us() {
+#ifdef NATIVE_BUILD
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#else
+    return esp_timer_get_time();
+#endif
+}
+
+void IRAM_ATTR perf_metrics_record(perf_metric_t metric, uint32_t us) {
+    if (metric >= PERF_METRIC_COUNT) return;
+    histogram_t &h = hist[metric];
+    h.buckets[bucket_index(us)].fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t max = h.max_us.load(std::memory_order_relaxed);
+    while (us > max && !h.max_us.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+    }
+}
+
+// Value below which pct percent of the samples fall, as the upper edge of its bucket
+static uint32_t percentile(const perf_metric_snapshot_t *s, uint32_t pct) {
+    uint32_t rank = (uint32_t)(((uint64_t)s->summary.count * pct + 99) / 100);
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (uint32_t b = 0; b < PERF_HIST_BUCKETS; b++) {
+        seen += s->buckets[b];
+        if (seen >= rank) {
+            uint32_t upper = perf_metrics_bucket_upper_us(b);
+            return upper < s->summary.max_us ? upper : s->summary.max_us;
+        }
+    }
+    return s->summary.max_us;
+}
+
+static void summarize(perf_metric_snapshot_t *s) {
+    perf_metric_summary_t &sum = s->summary;
+    uint64_t total_us = 0;
+    sum.count = 0;
+    sum.min_us = 0;
+    for (uint32_t b = 0; b < PERF_HIST_BUCKETS; b++) {
+        if (!s->buckets[b]) continue;
+        if (!sum.count) sum.min_us = perf_metrics_bucket_lower_us(b);
+        sum.count += s->buckets[b];
+        total_us += (uint64_t)s->buckets[b] *
+                    ((perf_metrics_bucket_lower_us(b) + perf_metrics_bucket_upper_us(b)) / 2);
+    }
+    if (!sum.count) {
+        memset(&sum, 0, sizeof(sum));
+        return;
+    }
+    sum.avg_us = (uint32_t)(total_us / sum.count);
+    sum.p50_us = percentile(s, 50);
+    sum.p95_us = percentile(s, 95);
+    sum.p99_us = percentile(s, 99);
+}
+
+static void copy(perf_metric_t metric, perf_metric_snapshot_t *out, bool take) {
+    if (!out || metric >= PERF_METRIC_COUNT) return;
+    histogram_t &h = hist[metric];
+    // Every sample lands in exactly one take: either it is exchanged out
+    // here or it is added after and counted by the next one
+    for (uint32_t b = 0; b < PERF_HIST_BUCKETS; b++) {
+        out->buckets[b] = take ? h.buckets[b].exchange(0, std::memory_order_relaxed)
+                               : h.buckets[b].load(std::memory_order_relaxed);
+    }
+    out->summary.max_us = take ? h.max_us.exchange(0, std::memory_order_relaxed)
+                               : h.max_us.load(std::memory_order_relaxed);
+    summarize(out);
+}
+
+void perf_metrics_snapshot(perf_metric_t metric, perf_metric_snapshot_t *snapshot) {
+    copy(metric, snapshot, false);
+}
+
+void perf_metrics_take(perf_metric_t metric, perf_metric_snapshot_t *snapshot) {
+    copy(metric, snapshot, true);
+}
+
+const char* perf_metrics_name(perf_metric_t metric) {
+    return metric < PERF_METRIC_COUNT ? metric_names[metric] : "?";
+}
+
+void perf_metrics_reset() {
+    for (int m = 0; m < PERF_METRIC_COUNT; m++) {
+        for (uint32_t b = 0; b < PERF_HIST_BUCKETS; b++) {
+            hist[m].buckets[b].store(0, std::memory_order_relaxed);
+        }
+        hist[m].max_us.store(0, std::memory_order_relaxed);
+    }
+}
+
+void perf_metrics_note_flush(uint32_t px) {
+    frame_px += px;
+}
+
+void perf_metrics_get_frame_counters(perf_frame_counters_t *out) {
+    if (!out) return;
+    *out = counters;
+    out->time_us = esp_timer_get_time();
+}
+
+void perf_metrics_frame_rates(const perf_frame_counters_t *from, const perf_frame_counters_t *to,
+                              perf_frame_rates_t *out) {
+    if (!from || !to || !out) return;
+    memset(out, 0, sizeof(*out));
+    int64_t elapsed_us = to->time_us - from->time_us;
+    uint32_t frames = to->frames - from->frames;
+    if (elapsed_us > 0) {
+        out->fps = frames * 1000000.0f / elapsed_us;
+        out->refreshes_per_s = (to->refreshes - from->refreshes) * 1000000.0f / elapsed_us;
+        out->px_per_s = (uint32_t)((to->flushed_px - from->flushed_px) * 1000000 / elapsed_us);
+    }
+    if (frames) {
+        out->dirty_pct = (to->dirty_x10000 - from->dirty_x10000) / 100.0f / frames;
+    }
+}
+
+static void refr_start_event_cb(lv_event_t *e) {
+    (void)e;
+    flush_scheduler_stats_t fs;
+    flush_scheduler_get_stats(&fs);
+    refr_start_frames = fs.frames;
+    refr_start_us = perf_metrics_now_us();
+    frame_px = 0;
+    counters.refreshes++;
+
+    // Lateness of this run against the period the timer ran at
+    int64_t tick_us = esp_timer_get_time();
+    int64_t period_us = (int64_t)refresh_governor_get_period_ms() * 1000;
+    int64_t interval_us = tick_us - last_refr_tick_us;
+    if (last_refr_tick_us && interval_us < 2 * period_us) {
+        perf_metrics_record(PERF_REFRESH_JITTER,
+                            (uint32_t)(interval_us > period_us ? interval_us - period_us : period_us - interval_us));
+    }
+    last_refr_tick_us = tick_us;
+}
+
+// Runs after the flush scheduler's REFR_READY, which counts the frame if it reached the panel
+static void refr_ready_event_cb(lv_event_t *e) {
+    flush_scheduler_stats_t fs;
+    flush_scheduler_get_stats(&fs);
+    if (!refr_start_us || fs.frames == refr_start_frames) return;
+    perf_metrics_record(PERF_RENDER, (uint32_t)(perf_metrics_now_us() - refr_start_us));
+
+    lv_display_t *disp = (lv_display_t*)lv_event_get_target(e);
+    uint32_t screen_px = (uint32_t)(lv_display_get_horizontal_resolution(disp) *
+                                    lv_display_get_vertical_resolution(disp));
+    counters.frames++;
+    counters.flushed_px += frame_px;
+    if (screen_px) {
+        // Areas can overlap, so clamp to the whole screen
+        uint64_t dirty = (uint64_t)frame_px * 10000 / screen_px;
+        counters.dirty_x10000 += dirty < 10000 ? dirty : 10000;
+    }
+}
+
+// Frame rates and metric percentiles of the period since the last report
+static void report() {
+    perf_frame_counters_t frames;
+    perf_frame_rates_t rates;
+    perf_metrics_get_frame_counters(&frames);
+    perf_metrics_frame_rates(&report_frames, &frames, &rates);
+    report_frames = frames;
+    ESP_LOGI(TAG, "FRAMES - %.1f fps (%.1f refreshes/s), %lu px/s flushed, %.1f%% of the screen per frame",
+             rates.fps, rates.refreshes_per_s, (unsigned long)rates.px_per_s, rates.dirty_pct);
+
+    // Take empties each histogram for the next period
+    static perf_metric_snapshot_t perf;
+    for (int m = 0; m < PERF_METRIC_COUNT; m++) {
+        perf_metrics_take((perf_metric_t)m, &perf);
+        if (perf.summary.count == 0) continue;
+        ESP_LOGI(TAG, "PERF %s - %lu samples, p50 %lu us, p95 %lu us, p99 %lu us, max %lu us (avg %lu)",
+                 perf_metrics_name((perf_metric_t)m), (unsigned long)perf.summary.count,
+                 (unsigned long)perf.summary.p50_us, (unsigned long)perf.summary.p95_us,
+                 (unsigned long)perf.summary.p99_us, (unsigned long)perf.summary.max_us,
+                 (unsigned long)perf.summary.avg_us);
+    }
+}
+
+bool perf_metrics_add_report(perf_report_cb_t report) {
+    if (!report) return false;
+    if (report_count >= PERF_REPORTS_MAX) {
+        ESP_LOGW(TAG, "No room for another report (PERF_REPORTS_MAX %d)", PERF_REPORTS_MAX);
+        return false;
+    }
+    reports[report_count++] = report;
+    return true;
+}
+
+void perf_metrics_report() {
+    for (uint32_t i = 0; i < report_count; i++) {
+        reports[i]();
+    }
+}
+
+void perf_metrics_init(lv_display_t *disp) {
+    perf_metrics_reset();
+    memset(&counters, 0, sizeof(counters));
+    perf_metrics_get_frame_counters(&report_frames);
+    last_refr_tick_us = 0;
+    perf_metrics_add_report(report);
+    lv_display_add_event_cb(disp, refr_start_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, refr_ready_event_cb, LV_EVENT_REFR_READY, NULL);
+    ESP_LOGI(TAG, "Perf metrics: %d buckets per metric, %d per power of two, up to %lu us",
+             PERF_HIST_BUCKETS, PERF_HIST_SUB_BUCKETS, (unsigned long)PERF_HIST_MAX_US);
+}
@@ -0,0 +1,144 @@
+#ifndef PERF_METRICS_HPP
+#define PERF_METRICS_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+
+/**
+ * Frame and input timing histograms
+ *
+ * Each metric is a log-linear histogram of microsecond durations: values
+ * below 16 us get a bucket each, above that every power of two is split
+ * into PERF_HIST_SUB_BUCKETS equal buckets, so any value is binned within
+ * 1/8 of itself from 1 us up to PERF_HIST_MAX_US. Percentiles read from
+ * the histogram carry that error; max is exact.
+ *
+ *   render         one display refresh, REFR_START to REFR_READY, frames
+ *                  that reached the panel only (includes waiting for the
+ *                  flush in blocking mode)
+ *   flush          what one buffer costs the flushing task: the blocking
+ *                  write, or in async mode queueing it plus waiting for
+ *                  its DMA (not the rendering or idle time in between, so
+ *                  a transfer hidden behind rendering costs only the
+ *                  queueing); the pipeline's flush task times its own job
+ *   input_latency  touch-to-photon of a tracked click (touch_latency.hpp)
+ *   timer_handler  one lv_timer_handler() call, flushed or not
+ *   refresh_jitter how far the refresh timer's runs are from its period
+ *                  (runs more than two periods apart are idle, not late)
+ *
+ * perf_metrics_record() only does 32-bit atomic adds, so flush tasks,
+ * ISRs and the other core can record without a lock. A snapshot taken while
+ * others record is a consistent set of counts, but not a cut at one instant.
+ *
+ * The device times with esp_timer; the native build times with the host's
+ * real clock, since its simulated clock only moves between loop iterations.
+ * Refresh jitter is on the clock LVGL's timers run on (esp_timer).
+ *
+ * Frames are counted from the same refresh events rather than loop()
+ * iterations: a refresh that drew nothing, or a loop pass that ran no
+ * refresh at all, is not a frame. The counters only grow, so any number of
+ * readers (the FPS label, the 10 s log) can each turn two readings into
+ * rates with perf_metrics_frame_rates().
+ *
+ * Modules with stats of their own register a report with
+ * perf_metrics_add_report(); perf_metrics_report() runs them all every
+ * reporting period (10 s in loop()). Each report logs its stats since the
+ * last one and resets them. This module's own report logs the frame rates
+ * and every metric that had samples, and empties the histograms.
+ */
+
+// Reports perf_metrics_add_report() can hold
+#ifndef PERF_REPORTS_MAX
+#define PERF_REPORTS_MAX 12
+#endif
+
+// Buckets per power of two (power of two)
+#define PERF_HIST_SUB_BITS 3
+#define PERF_HIST_SUB_BUCKETS (1 << PERF_HIST_SUB_BITS)
+
+// Longer durations land in the last bucket (16.7 s)
+#define PERF_HIST_MAX_BITS 24
+#define PERF_HIST_MAX_US ((1UL << PERF_HIST_MAX_BITS) - 1)
+
+#define PERF_HIST_BUCKETS ((PERF_HIST_MAX_BITS - PERF_HIST_SUB_BITS + 1) * PERF_HIST_SUB_BUCKETS)
+
+typedef enum {
+    PERF_RENDER = 0,
+    PERF_FLUSH,
+    PERF_INPUT_LATENCY,
+    PERF_TIMER_HANDLER,
+    PERF_REFRESH_JITTER,
+    PERF_METRIC_COUNT
+} perf_metric_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;       // Lower edge of the lowest bucket used
+    uint32_t avg_us;       // From bucket midpoints
+    uint32_t p50_us;
+    uint32_t p95_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+} perf_metric_summary_t;
+
+typedef struct {
+    perf_metric_summary_t summary;
+    uint32_t buckets[PERF_HIST_BUCKETS];
+} perf_metric_snapshot_t;
+
+// Frame accounting since init (LVGL task)
+typedef struct {
+    int64_t time_us;            // When it was read (esp_timer)
+    uint32_t refreshes;         // Runs of the refresh timer
+    uint32_t frames;            // Refreshes that reached the panel
+    uint64_t flushed_px;        // Pixels written to the panel
+    uint64_t dirty_x10000;      // Sum over frames of the share of the screen redrawn, in 1/10000
+} perf_frame_counters_t;
+
+typedef struct {
+    float fps;                  // Frames that reached the panel per second
+    float refreshes_per_s;
+    uint32_t px_per_s;          // Flushed pixels per second
+    float dirty_pct;            // Share of the screen an average frame redrew
+} perf_frame_rates_t;
+
+// Hook the display's refresh events for PERF_RENDER, jitter and frames (call after flush_scheduler_init)
+void perf_metrics_init(lv_display_t *disp);
+
+// Clock the metrics are timed with, in microseconds
+int64_t perf_metrics_now_us();
+
+// Add one duration (any task, either core, ISR)
+void perf_metrics_record(perf_metric_t metric, uint32_t us);
+
+// Pixels of one flush that go to the panel (flush callback)
+void perf_metrics_note_flush(uint32_t px);
+
+void perf_metrics_get_frame_counters(perf_frame_counters_t *counters);
+
+// Rates between two readings of the counters
+void perf_metrics_frame_rates(const perf_frame_counters_t *from, const perf_frame_counters_t *to,
+                              perf_frame_rates_t *rates);
+
+// Copy a metric's histogram and summary; take also empties it, without losing samples in between
+void perf_metrics_snapshot(perf_metric_t metric, perf_metric_snapshot_t *snapshot);
+void perf_metrics_take(perf_metric_t metric, perf_metric_snapshot_t *snapshot);
+
+// Bucket range: values from lower up to upper (inclusive)
+uint32_t perf_metrics_bucket_lower_us(uint32_t bucket);
+uint32_t perf_metrics_bucket_upper_us(uint32_t bucket);
+
+const char* perf_metrics_name(perf_metric_t metric);
+
+void perf_metrics_reset();
+
+// Log and reset a module's stats for the period since its last report (LVGL task)
+typedef void (*perf_report_cb_t)(void);
+
+// Add a report, run in the order added; false when PERF_REPORTS_MAX are taken
+bool perf_metrics_add_report(perf_report_cb_t report);
+
+// Run every report (once per reporting period, LVGL task)
+void perf_metrics_report();
+
+#endif // PERF_METRICS_HPP
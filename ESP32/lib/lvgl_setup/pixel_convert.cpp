@@ -0,0 +1,208 @@
+#include "pixel_convert.hpp"
+#include "shadow_fb.hpp"
+#include "bus_arbiter.hpp"
+#include "display.hpp"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <chrono>
+
+static const char* TAG = "PIXEL";
+
+static int active_pipeline = LVGL_PIXEL_PIPELINE;
+
+#if LV_COLOR_DEPTH == 16
+// RGB565 split by byte: the high byte holds RRRRRGGG, the low byte GGGBBBBB.
+// Each table expands its part to 8-bit channels (low bits replicated) so a
+// pixel costs two lookups and one OR for the shared green channel.
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+} lut_hi_t;
+
+typedef struct {
+    uint8_t g;
+    uint8_t b;
+} lut_lo_t;
+
+static lut_hi_t lut_hi[256];
+static lut_lo_t lut_lo[256];
+
+// Two DMA-capable buffers in the panel's R,G,B byte order
+static uint8_t *bounce[2] = {NULL, NULL};
+static int bounce_next = 0;
+
+static void build_tables() {
+    for (int i = 0; i < 256; i++) {
+        uint8_t r5 = i >> 3;
+        uint8_t g6_top = (i & 0x07) << 3;
+        lut_hi[i].r = (r5 << 3) | (r5 >> 2);
+        // g6 >> 4 only depends on the top green bits, so the whole
+        // (g6 << 2) | (g6 >> 4) expansion splits cleanly between tables
+        lut_hi[i].g = (g6_top << 2) | (g6_top >> 4);
+
+        uint8_t g6_bottom = i >> 5;
+        uint8_t b5 = i & 0x1F;
+        lut_lo[i].g = g6_bottom << 2;
+        lut_lo[i].b = (b5 << 3) | (b5 >> 2);
+    }
+}
+
+static void convert_chunk(const uint16_t *src, uint8_t *dst, int32_t len) {
+    for (int32_t i = 0; i < len; i++) {
+        uint16_t p = src[i];
+        const lut_hi_t &hi = lut_hi[p >> 8];
+        const lut_lo_t &lo = lut_lo[p & 0xFF];
+        dst[0] = hi.r;
+        dst[1] = hi.g | lo.g;
+        dst[2] = lo.b;
+        dst += 3;
+    }
+}
+#endif
+
+void pixel_convert_init() {
+#if LV_COLOR_DEPTH == 16
+    if (active_pipeline == PIXEL_PIPELINE_LUT) {
+        build_tables();
+        for (int i = 0; i < 2; i++) {
+            if (!bounce[i]) {
+                bounce[i] = (uint8_t*)heap_caps_malloc(PIXEL_BOUNCE_PX * 3, MALLOC_CAP_DMA);
+            }
+        }
+        if (!bounce[0] || !bounce[1]) {
+            ESP_LOGW(TAG, "No DMA memory for bounce buffers, LovyanGFX converts instead");
+            heap_caps_free(bounce[0]);
+            heap_caps_free(bounce[1]);
+            bounce[0] = bounce[1] = NULL;
+            active_pipeline = PIXEL_PIPELINE_LGFX;
+        }
+    }
+#endif
+    ESP_LOGI(TAG, "Pixel pipeline: %s", pixel_convert_pipeline_name(active_pipeline));
+}
+
+int pixel_convert_get_pipeline() {
+    return active_pipeline;
+}
+
+const char* pixel_convert_pipeline_name(int pipeline) {
+    switch (pipeline) {
+        case PIXEL_PIPELINE_LGFX: return "lgfx";
+        case PIXEL_PIPELINE_LUT: return "lut";
+        case PIXEL_PIPELINE_NATIVE24: return "native24";
+        default: return "unknown";
+    }
+}
+
+void pixel_convert_write(const flush_px_t *px, int32_t len, bool use_dma) {
+#if LV_COLOR_DEPTH == 24
+    // LVGL's B,G,R is LovyanGFX's rgb888_t; only a byte swap remains
+    if (use_dma) gfx.writePixelsDMA((const lgfx::rgb888_t*)px, len);
+    else gfx.writePixels((const lgfx::rgb888_t*)px, len);
+#else
+    if (active_pipeline == PIXEL_PIPELINE_LGFX) {
+        if (use_dma) gfx.writePixelsDMA((const lgfx::rgb565_t*)px, len);
+        else gfx.writePixels((const lgfx::rgb565_t*)px, len);
+        return;
+    }
+
+    // Ping-pong: a DMA write starts only after the previous one finished, so
+    // once a chunk is queued the buffer before it is free to convert into
+    while (len > 0) {
+        int32_t n = len < PIXEL_BOUNCE_PX ? len : PIXEL_BOUNCE_PX;
+        uint8_t *buf = bounce[bounce_next];
+        bounce_next ^= 1;
+        convert_chunk(px, buf, n);
+        // Already in wire format: no second conversion inside LovyanGFX
+        gfx.writeWireBytesDMA(buf, (uint32_t)n * 3);
+        px += n;
+        len -= n;
+    }
+    if (!use_dma) {
+        gfx.waitDMA();
+    }
+#endif
+}
+
+static void fill_test_pattern(flush_px_t *px, int32_t w, int32_t h) {
+    // Gradients in every channel so no pixel run is trivially uniform
+    for (int32_t y = 0; y < h; y++) {
+        for (int32_t x = 0; x < w; x++) {
+            uint8_t r = (uint8_t)(x * 255 / w);
+            uint8_t g = (uint8_t)(y * 255 / h);
+            uint8_t b = (uint8_t)((x + y) * 4);
+#if LV_COLOR_DEPTH == 24
+            px[y * w + x] = {b, g, r};
+#else
+            px[y * w + x] = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+#endif
+        }
+    }
+}
+
+int pixel_convert_benchmark(uint32_t frames, pixel_pipeline_bench_t *results, int max_results) {
+    const int32_t w = gfx.width();
+    const int32_t h = gfx.height();
+    const int32_t band = 40;  // Rows per window, about one draw buffer
+
+    if (frames == 0) return 0;
+
+    flush_px_t *pattern = (flush_px_t*)heap_caps_malloc(w * band * sizeof(flush_px_t), MALLOC_CAP_8BIT);
+    if (!pattern) {
+        ESP_LOGE(TAG, "Failed to allocate benchmark pattern");
+        return 0;
+    }
+    fill_test_pattern(pattern, w, band);
+
+    int candidates[3];
+    int num_candidates = 0;
+#if LV_COLOR_DEPTH == 24
+    candidates[num_candidates++] = PIXEL_PIPELINE_NATIVE24;
+#else
+    candidates[num_candidates++] = PIXEL_PIPELINE_LGFX;
+    if (bounce[0]) {
+        candidates[num_candidates++] = PIXEL_PIPELINE_LUT;
+    }
+#endif
+
+    int saved_pipeline = active_pipeline;
+    int count = 0;
+
+    // Keep the touch task off the bus for the whole run
+    bus_arbiter_acquire(BUS_CLIENT_DISPLAY, UINT32_MAX);
+
+    for (int c = 0; c < num_candidates && count < max_results; c++) {
+        active_pipeline = candidates[c];
+
+        auto start = std::chrono::steady_clock::now();
+        gfx.startWrite();
+        for (uint32_t f = 0; f < frames; f++) {
+            for (int32_t y = 0; y < h; y += band) {
+                int32_t rows = (h - y) < band ? (h - y) : band;
+                gfx.setAddrWindow(0, y, w, rows);
+                pixel_convert_write(pattern, w * rows, true);
+            }
+        }
+        gfx.endWrite();  // Waits for the last transfer
+        uint64_t elapsed_us = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        if (elapsed_us == 0) elapsed_us = 1;
+
+        uint64_t wire_bytes = (uint64_t)w * h * TFT_WIRE_BYTES_PER_PIXEL * frames;
+        results[count].pipeline = candidates[c];
+        results[count].frame_us = (uint32_t)(elapsed_us / frames);
+        results[count].bytes_per_s = (uint32_t)(wire_bytes * 1000000ULL / elapsed_us);
+        ESP_LOGI(TAG, "%-8s %6u us/frame, %6u KB/s",
+                 pixel_convert_pipeline_name(candidates[c]),
+                 (unsigned)results[count].frame_us, (unsigned)(results[count].bytes_per_s / 1024));
+        count++;
+    }
+
+    active_pipeline = saved_pipeline;
+    heap_caps_free(pattern);
+
+    gfx.fillScreen(0x0000);
+    bus_arbiter_release(BUS_CLIENT_DISPLAY);
+    shadow_fb_invalidate();
+    return count;
+}
@@ -0,0 +1,90 @@
+#ifndef PIXEL_CONVERT_HPP
+#define PIXEL_CONVERT_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+#include "flush_pixel.hpp"
+
+/**
+ * Pixel pipeline between the LVGL draw buffer and the ILI9488
+ *
+ * Over SPI the ILI9488 only accepts 18-bit color, 3 bytes per pixel, so
+ * every RGB565 pixel LVGL renders has to be expanded on its way out. The
+ * pipeline decides who does that work:
+ *
+ *  - LGFX:     hand RGB565 to LovyanGFX and let it convert (original path)
+ *  - LUT:      expand with two 256-entry tables into a pair of DMA bounce
+ *              buffers, which are DMA'd to the bus byte for byte
+ *              (gfx.writeWireBytesDMA), bypassing LovyanGFX's own color
+ *              conversion; the next chunk is converted while the previous
+ *              one is on the wire
+ *  - NATIVE24: LVGL renders 24-bit (LV_COLOR_DEPTH=24), nothing to expand;
+ *              LovyanGFX only swaps B,G,R to the panel's R,G,B
+ *
+ * NATIVE24 trades 50% more draw buffer RAM and render bandwidth for no
+ * expansion. The other two need LV_COLOR_DEPTH=16.
+ */
+
+#define PIXEL_PIPELINE_LGFX     0
+#define PIXEL_PIPELINE_LUT      1
+#define PIXEL_PIPELINE_NATIVE24 2
+
+#ifndef LVGL_PIXEL_PIPELINE
+#if LV_COLOR_DEPTH == 24
+#define LVGL_PIXEL_PIPELINE PIXEL_PIPELINE_NATIVE24
+#else
+#define LVGL_PIXEL_PIPELINE PIXEL_PIPELINE_LUT
+#endif
+#endif
+
+#if (LVGL_PIXEL_PIPELINE == PIXEL_PIPELINE_NATIVE24) != (LV_COLOR_DEPTH == 24)
+#error "PIXEL_PIPELINE_NATIVE24 requires LV_COLOR_DEPTH=24, the other pipelines LV_COLOR_DEPTH=16"
+#endif
+
+// Full-screen frames per pipeline pushed at boot by pixel_convert_benchmark() (0 = off)
+#ifndef PIXEL_PIPELINE_BENCHMARK
+#define PIXEL_PIPELINE_BENCHMARK 0
+#endif
+
+// Pixels per bounce buffer of the LUT pipeline (two are allocated, 3 bytes/pixel)
+#ifndef PIXEL_BOUNCE_PX
+#define PIXEL_BOUNCE_PX 1024
+#endif
+
+typedef struct {
+    int pipeline;
+    uint32_t frame_us;         // Full-screen push, average over the run
+    uint32_t bytes_per_s;      // Wire bytes per second
+} pixel_pipeline_bench_t;
+
+/**
+ * Allocate the LUT pipeline's tables and bounce buffers
+ *
+ * Falls back to PIXEL_PIPELINE_LGFX when DMA memory is not available.
+ */
+void pixel_convert_init();
+
+// Pipeline actually in use
+int pixel_convert_get_pipeline();
+
+// Printable name of a PIXEL_PIPELINE_* value
+const char* pixel_convert_pipeline_name(int pipeline);
+
+/**
+ * Send len pixels into the current address window
+ *
+ * The caller holds the transaction. With use_dma the last chunk may still
+ * be on the wire when this returns.
+ */
+void pixel_convert_write(const flush_px_t *px, int32_t len, bool use_dma);
+
+/**
+ * Push full-screen test frames through every pipeline this build supports
+ *
+ * Meant to run once at boot, before the UI exists. Writes up to max_results
+ * entries and returns how many were written. Leaves the panel black and the
+ * shadow framebuffer invalidated.
+ */
+int pixel_convert_benchmark(uint32_t frames, pixel_pipeline_bench_t *results, int max_results);
+
+#endif // PIXEL_CONVERT_HPP
@@ -0,0 +1,291 @@
+#include "power_manager.hpp"
+#include "lvgl_setup.hpp"
+#include "flush_scheduler.hpp"
+#include "bus_arbiter.hpp"
+#include "perf_metrics.hpp"
+#include "display.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <Arduino.h>
+#include <string.h>
+
+#ifndef NATIVE_BUILD
+#include <driver/gpio.h>
+#include <driver/uart.h>
+#include <esp_sleep.h>
+#endif
+
+static const char* TAG = "POWER";
+
+static power_state_t state = POWER_ACTIVE;
+static uint8_t brightness = 255;
+static int64_t last_busy_us = 0;       // Last animation, touch or frame
+static uint32_t last_frames = 0;
+static bool dropping_press = false;
+
+static power_manager_stats_t stats;
+static int64_t stats_since_us = 0;
+static int64_t state_since_us = 0;
+static uint64_t wake_latency_sum_us = 0;
+
+// Panel coming out of sleep; the wake completes when this fires
+static lv_timer_t *panel_wake_timer = NULL;
+static int64_t panel_wake_sample_us = 0;   // Touch sample that woke it (0 = none)
+
+#ifdef NATIVE_BUILD
+static uint32_t cpu_mhz = POWER_FULL_CPU_MHZ;
+#endif
+
+static const char* const state_names[POWER_STATE_COUNT] = {
+    "active", "idle", "dim", "panel_off"
+};
+
+static void account(int64_t now) {
+    stats.state_us[state] += (uint64_t)(now - state_since_us);
+    state_since_us = now;
+}
+
+static void set_cpu_mhz(uint32_t mhz) {
+#ifdef NATIVE_BUILD
+    cpu_mhz = mhz;
+#else
+    if (getCpuFrequencyMhz() != mhz) setCpuFrequencyMhz(mhz);
+#endif
+}
+
+static void record_wake(int64_t sample_us) {
+    uint32_t latency_us = (uint32_t)(esp_timer_get_time() - sample_us);
+    stats.wakes++;
+    wake_latency_sum_us += latency_us;
+    if (latency_us > stats.wake_latency_max_us) stats.wake_latency_max_us = latency_us;
+}
+
+static void apply_brightness() {
+    gfx.setBrightness(state == POWER_DIM ? (uint8_t)(brightness * POWER_DIM_PERCENT / 100) : brightness);
+}
+
+static void panel_off() {
+    if (panel_wake_timer) {
+        // Back to sleep before the last wake completed
+        lv_timer_delete(panel_wake_timer);
+        panel_wake_timer = NULL;
+        panel_wake_sample_us = 0;
+    }
+    gfx.setBrightness(0);
+    // Nothing in flight, and nothing new: the panel does not show it
+    lvgl_flush_wait_idle();
+    lv_display_enable_invalidation(disp, false);
+
+    bus_arbiter_acquire(BUS_CLIENT_DISPLAY, UINT32_MAX);
+    gfx.sleep();
+    bus_arbiter_release(BUS_CLIENT_DISPLAY);
+}
+
+// The panel accepts commands again: redraw it, then light it
+static void panel_ready_cb(lv_timer_t *timer) {
+    (void)timer;
+    panel_wake_timer = NULL;
+
+    // The panel kept its memory, but LVGL dropped everything that changed since
+    lv_display_enable_invalidation(disp, true);
+    lv_obj_invalidate(lv_display_get_screen_active(disp));
+    apply_brightness();
+
+    if (panel_wake_sample_us) record_wake(panel_wake_sample_us);
+    panel_wake_sample_us = 0;
+}
+
+// Runs from the read callback: wait out SLPOUT on an LVGL timer, not in it
+static void panel_on() {
+    bus_arbiter_acquire(BUS_CLIENT_DISPLAY, UINT32_MAX);
+    gfx.wakeup();
+    bus_arbiter_release(BUS_CLIENT_DISPLAY);
+
+    panel_wake_timer = lv_timer_create(panel_ready_cb, POWER_PANEL_WAKE_MS, NULL);
+    lv_timer_set_repeat_count(panel_wake_timer, 1);
+}
+
+static void enter(power_state_t next) {
+    if (next == state) return;
+    int64_t now = esp_timer_get_time();
+    account(now);
+
+    set_cpu_mhz(next == POWER_ACTIVE ? POWER_FULL_CPU_MHZ : POWER_IDLE_CPU_MHZ);
+    ESP_LOGD(TAG, "%s -> %s", state_names[state], state_names[next]);
+    power_state_t prev = state;
+    state = next;
+    stats.transitions++;
+
+    if (next == POWER_PANEL_OFF) {
+        panel_off();
+    } else if (prev == POWER_PANEL_OFF) {
+        panel_on();  // Lit once the panel is ready
+    } else if (!panel_wake_timer) {
+        apply_brightness();
+    }
+}
+
+// Where the time went since the last report, and how fast a touch brought the board back
+static void report() {
+    power_manager_stats_t power;
+    power_manager_get_stats(&power);
+    ESP_LOGI(TAG, "POWER - %s at %lu MHz, awake %lu.%02lu%%, %lu light sleeps (%llu ms), active/idle/dim/off %llu/%llu/%llu/%llu ms, %lu wakes (latency %lu us avg, max %lu)",
+             state_names[state], (unsigned long)power.cpu_mhz,
+             (unsigned long)(power.duty_x100 / 100), (unsigned long)(power.duty_x100 % 100),
+             (unsigned long)power.light_sleeps, (unsigned long long)(power.light_sleep_us / 1000),
+             (unsigned long long)(power.state_us[POWER_ACTIVE] / 1000),
+             (unsigned long long)(power.state_us[POWER_IDLE] / 1000),
+             (unsigned long long)(power.state_us[POWER_DIM] / 1000),
+             (unsigned long long)(power.state_us[POWER_PANEL_OFF] / 1000),
+             (unsigned long)power.wakes, (unsigned long)power.wake_latency_avg_us,
+             (unsigned long)power.wake_latency_max_us);
+    power_manager_reset_stats();
+}
+
+void power_manager_init() {
+    state = POWER_ACTIVE;
+    last_busy_us = esp_timer_get_time();
+    flush_scheduler_stats_t fs;
+    flush_scheduler_get_stats(&fs);
+    last_frames = fs.frames;
+    set_cpu_mhz(POWER_FULL_CPU_MHZ);
+    power_manager_reset_stats();
+    perf_metrics_add_report(report);
+
+#if !POWER_MANAGER
+    ESP_LOGI(TAG, "Power manager disabled");
+#else
+#if POWER_LIGHT_SLEEP && !defined(NATIVE_BUILD)
+    // PENIRQ ends a light sleep; the touch sampler's interrupt then runs as usual
+    gpio_wakeup_enable((gpio_num_t)TFT_TOUCH_PIN_INT, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+#endif
+    ESP_LOGI(TAG, "CPU %d/%d MHz, idle after %d ms, dim after %d s, panel off after %d s, light sleep %s",
+             POWER_FULL_CPU_MHZ, POWER_IDLE_CPU_MHZ, POWER_IDLE_MS, POWER_DIM_MS / 1000,
+             POWER_PANEL_OFF_MS / 1000, POWER_LIGHT_SLEEP ? "on" : "off");
+#endif
+}
+
+void power_manager_update() {
+#if POWER_MANAGER
+    if (!disp) return;
+    int64_t now = esp_timer_get_time();
+
+    flush_scheduler_stats_t fs;
+    flush_scheduler_get_stats(&fs);
+    bool framed = fs.frames != last_frames;
+    last_frames = fs.frames;
+    bool busy = lv_anim_count_running() > 0 ||
+                (indev && lv_indev_get_state(indev) == LV_INDEV_STATE_PRESSED);
+    if (busy || framed) last_busy_us = now;
+
+    uint32_t inactive_ms = lv_display_get_inactive_time(disp);
+    power_state_t next;
+    if (inactive_ms >= POWER_PANEL_OFF_MS) {
+        next = POWER_PANEL_OFF;
+    } else if (inactive_ms >= POWER_DIM_MS) {
+        next = state > POWER_DIM ? state : POWER_DIM;  // Only input brings it back
+    } else if (busy) {
+        next = POWER_ACTIVE;
+    } else if (now - last_busy_us >= (int64_t)POWER_IDLE_MS * 1000) {
+        next = state > POWER_IDLE ? state : POWER_IDLE;
+    } else {
+        next = state;
+    }
+    enter(next);
+#endif
+}
+
+uint32_t power_manager_light_sleep(uint32_t sleep_ms) {
+#if POWER_MANAGER && POWER_LIGHT_SLEEP
+    // Only with the backlight off: its PWM stops in light sleep
+    if (state != POWER_PANEL_OFF || sleep_ms < POWER_LIGHT_SLEEP_MIN_MS) return sleep_ms;
+
+    // The SPI peripheral stops with the cores: finish the transfer in flight
+    lvgl_flush_wait_idle();
+    int64_t start = esp_timer_get_time();
+#ifdef NATIVE_BUILD
+    esp_timer_host_advance((uint64_t)sleep_ms * 1000);
+#else
+    // A finger already down would wake the chip at once
+    if (gpio_get_level((gpio_num_t)TFT_TOUCH_PIN_INT) == 0) return sleep_ms;
+    // Let the log line in the UART FIFO out first
+    uart_wait_tx_idle_polling((uart_port_t)CONFIG_ESP_CONSOLE_UART_NUM);
+    esp_sleep_enable_timer_wakeup((uint64_t)sleep_ms * 1000);
+    esp_light_sleep_start();
+#endif
+    uint64_t slept_us = (uint64_t)(esp_timer_get_time() - start);
+    stats.light_sleeps++;
+    stats.light_sleep_us += slept_us;
+
+    // Woken early by the touch interrupt: the rest is a normal wait
+    uint32_t slept_ms = (uint32_t)(slept_us / 1000);
+    return slept_ms >= sleep_ms ? 0 : sleep_ms - slept_ms;
+#else
+    return sleep_ms;
+#endif
+}
+
+bool power_manager_touch(const touch_sample_t *sample) {
+#if POWER_MANAGER
+    if (dropping_press) {
+        if (!sample->pressed) dropping_press = false;
+        return true;
+    }
+    if (!sample->pressed || state == POWER_ACTIVE) return false;
+
+    bool was_off = state == POWER_PANEL_OFF;
+    enter(POWER_ACTIVE);
+    last_busy_us = esp_timer_get_time();
+    // A dropped press never reaches LVGL's inactivity timer
+    lv_display_trigger_activity(disp);
+
+    if (was_off) {
+        // Counted when the panel is lit
+        panel_wake_sample_us = sample->time_us;
+        stats.dropped_presses++;
+        dropping_press = true;
+        return true;
+    }
+    record_wake(sample->time_us);
+#else
+    (void)sample;
+#endif
+    return false;
+}
+
+void power_manager_set_brightness(uint8_t level) {
+    brightness = level;
+    if (state == POWER_PANEL_OFF || panel_wake_timer) return;  // Applied on wake
+    apply_brightness();
+}
+
+power_state_t power_manager_get_state() {
+    return state;
+}
+
+const char* power_manager_state_name(power_state_t s) {
+    return s < POWER_STATE_COUNT ? state_names[s] : "?";
+}
+
+void power_manager_get_stats(power_manager_stats_t *out) {
+    if (!out) return;
+    account(esp_timer_get_time());
+    *out = stats;
+#ifdef NATIVE_BUILD
+    out->cpu_mhz = cpu_mhz;
+#else
+    out->cpu_mhz = getCpuFrequencyMhz();
+#endif
+    out->elapsed_us = (uint64_t)(esp_timer_get_time() - stats_since_us);
+    out->duty_x100 = out->elapsed_us ?
+        (uint32_t)((out->elapsed_us - stats.light_sleep_us) * 10000 / out->elapsed_us) : 10000;
+    out->wake_latency_avg_us = stats.wakes ? (uint32_t)(wake_latency_sum_us / stats.wakes) : 0;
+}
+
+void power_manager_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+    wake_latency_sum_us = 0;
+    stats_since_us = esp_timer_get_time();
+    state_since_us = stats_since_us;
+}
@@ -0,0 +1,138 @@
+#ifndef POWER_MANAGER_HPP
+#define POWER_MANAGER_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+#include "touch_sampler.hpp"
+
+/**
+ * Idle power manager
+ *
+ * Looks at LVGL after every lv_timer_handler() and steps the board down as
+ * the UI goes quiet:
+ *
+ *   ACTIVE     full CPU speed
+ *   IDLE       no animation or touch, and no frame for POWER_IDLE_MS: the CPU
+ *              runs at POWER_IDLE_CPU_MHZ
+ *   DIM        no input for POWER_DIM_MS: backlight at POWER_DIM_PERCENT
+ *   PANEL_OFF  no input for POWER_PANEL_OFF_MS: backlight off, ILI9488 in
+ *              sleep mode, LVGL stops invalidating (redrawn on wake), and
+ *              lvgl_task_wait() light-sleeps until the next LVGL timer or
+ *              the touch interrupt
+ *
+ * Light sleep is limited to PANEL_OFF because of the backlight: LovyanGFX's
+ * Light_PWM drives it from an LEDC channel clocked from APB, which stops in
+ * light sleep, so a lit (or dimmed) backlight would freeze at whatever level
+ * the PWM output was at. With the backlight at 0 there is nothing to freeze.
+ *
+ * A running animation brings IDLE back to ACTIVE. Frames only keep the
+ * manager from stepping down, so a clock label ticking once a second is
+ * drawn at the idle speed. Only input leaves DIM and PANEL_OFF.
+ *
+ * The first touch sample goes straight back to ACTIVE, from the read
+ * callback before LVGL sees it. The press that wakes a dark panel is
+ * dropped up to its release, so it cannot click what was on the screen.
+ * The panel needs POWER_PANEL_WAKE_MS after SLPOUT; that wait runs on a
+ * one-shot LVGL timer, which then redraws and lights the panel, so the
+ * read callback never blocks.
+ *
+ * In the native build the CPU frequency is only recorded and a light sleep
+ * advances the simulated clock, so the policy runs on the scripted session.
+ */
+
+// 0 = always ACTIVE
+#ifndef POWER_MANAGER
+#define POWER_MANAGER 1
+#endif
+
+#ifndef POWER_FULL_CPU_MHZ
+#define POWER_FULL_CPU_MHZ 240
+#endif
+
+// 80 keeps APB at 80 MHz, so the SPI clocks do not change
+#ifndef POWER_IDLE_CPU_MHZ
+#define POWER_IDLE_CPU_MHZ 80
+#endif
+
+// No animation, touch or frame for this long before the CPU steps down
+#ifndef POWER_IDLE_MS
+#define POWER_IDLE_MS 500
+#endif
+
+// Light sleep between LVGL timers with the panel off (both cores stop)
+#ifndef POWER_LIGHT_SLEEP
+#define POWER_LIGHT_SLEEP 1
+#endif
+
+// Shorter waits stay a plain task wait (sleep entry and exit cost ~1 ms)
+#ifndef POWER_LIGHT_SLEEP_MIN_MS
+#define POWER_LIGHT_SLEEP_MIN_MS 20
+#endif
+
+#ifndef POWER_DIM_MS
+#define POWER_DIM_MS 30000
+#endif
+
+// Dimmed backlight, percent of the level set in the settings
+#ifndef POWER_DIM_PERCENT
+#define POWER_DIM_PERCENT 25
+#endif
+
+#ifndef POWER_PANEL_OFF_MS
+#define POWER_PANEL_OFF_MS 120000
+#endif
+
+// ILI9488: no command for 5 ms after sleep out
+#define POWER_PANEL_WAKE_MS 5
+
+typedef enum {
+    POWER_ACTIVE = 0,
+    POWER_IDLE,
+    POWER_DIM,
+    POWER_PANEL_OFF,
+    POWER_STATE_COUNT
+} power_state_t;
+
+typedef struct {
+    uint32_t cpu_mhz;            // Current CPU frequency
+    uint64_t state_us[POWER_STATE_COUNT];  // Time spent in each state
+    uint32_t transitions;
+    uint32_t light_sleeps;
+    uint64_t light_sleep_us;     // Time both cores were stopped
+    uint64_t elapsed_us;         // Since the last reset
+    uint32_t duty_x100;          // Awake share of elapsed_us, x100
+    uint32_t wakes;              // Touches that restored ACTIVE
+    uint32_t wake_latency_avg_us;  // First touch sample to full speed (and a lit panel)
+    uint32_t wake_latency_max_us;
+    uint32_t dropped_presses;    // Presses that woke the panel
+} power_manager_stats_t;
+
+// Start in ACTIVE (call after init_lvgl_input_device)
+void power_manager_init();
+
+// Step down or up from what the last lv_timer_handler() did (LVGL task, under lv_lock())
+void power_manager_update();
+
+/**
+ * Light-sleep through part of a wait of sleep_ms, when the state allows it
+ * (LVGL task, from lvgl_task_wait()). Returns what is left to wait: 0 after
+ * a full sleep, sleep_ms when it did not sleep.
+ */
+uint32_t power_manager_light_sleep(uint32_t sleep_ms);
+
+/**
+ * Look at a touch sample before LVGL does (read callback); wakes to ACTIVE
+ * on a press. Returns true when the sample must be dropped.
+ */
+bool power_manager_touch(const touch_sample_t *sample);
+
+// Backlight level chosen by the user (0-255); dimming is relative to it
+void power_manager_set_brightness(uint8_t level);
+
+power_state_t power_manager_get_state();
+const char* power_manager_state_name(power_state_t state);
+
+void power_manager_get_stats(power_manager_stats_t *stats);
+void power_manager_reset_stats();
+
+#endif // POWER_MANAGER_HPP
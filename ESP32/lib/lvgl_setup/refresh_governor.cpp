@@ -0,0 +1,187 @@
+#include "refresh_governor.hpp"
+#include "lvgl_setup.hpp"
+#include "flush_scheduler.hpp"
+#include "perf_metrics.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+
+static const char* TAG = "REFRESH";
+
+static const uint32_t level_period_ms[REFRESH_LEVEL_COUNT] = {
+    REFRESH_FULL_MS, REFRESH_STATIC_MS, REFRESH_AMBIENT_MS
+};
+static const char* const level_names[REFRESH_LEVEL_COUNT] = {
+    "full", "static", "ambient"
+};
+
+static lv_display_t *gov_disp = NULL;
+static refresh_level_t level = REFRESH_FULL;
+static int64_t last_motion_us = 0;
+static int64_t last_change_us = 0;
+static uint32_t last_frames = 0;
+static lv_obj_t *ambient[REFRESH_AMBIENT_MAX];
+
+static refresh_governor_stats_t stats;
+static int64_t level_since_us = 0;
+
+static void account(int64_t now) {
+    stats.dwell_us[level] += (uint64_t)(now - level_since_us);
+    level_since_us = now;
+}
+
+static void set_level(refresh_level_t next) {
+    if (next == level) return;
+    account(esp_timer_get_time());
+    level = next;
+    stats.switches++;
+    // Takes effect at once: a shorter period makes an overdue timer run in this handler
+    lv_timer_set_period(lv_display_get_refr_timer(gov_disp), level_period_ms[level]);
+}
+
+static bool is_ambient(const lv_area_t *area) {
+    for (int i = 0; i < REFRESH_AMBIENT_MAX; i++) {
+        if (!ambient[i]) continue;
+        lv_area_t coords;
+        lv_obj_get_coords(ambient[i], &coords);
+        if (lv_area_is_in(area, &coords, 0)) return true;
+        // Shadows and outlines are invalidated around the object
+        int32_t ext = lv_obj_get_ext_draw_size(ambient[i]);
+        coords.x1 -= ext;
+        coords.y1 -= ext;
+        coords.x2 += ext;
+        coords.y2 += ext;
+        if (ext && lv_area_is_in(area, &coords, 0)) return true;
+    }
+    return false;
+}
+
+static void invalidate_event_cb(lv_event_t *e) {
+    const lv_area_t *area = (const lv_area_t *)lv_event_get_param(e);
+    if (area && is_ambient(area)) {
+        stats.ambient_invalidations++;
+        return;
+    }
+    last_change_us = esp_timer_get_time();
+}
+
+static void ambient_delete_cb(lv_event_t *e) {
+    lv_obj_t *obj = (lv_obj_t *)lv_event_get_target(e);
+    for (int i = 0; i < REFRESH_AMBIENT_MAX; i++) {
+        if (ambient[i] == obj) ambient[i] = NULL;
+    }
+}
+
+// Which refresh rate the screen ran at since the last report, and how many frames each drew
+static void report() {
+    refresh_governor_stats_t refresh;
+    refresh_governor_get_stats(&refresh);
+    ESP_LOGI(TAG, "REFRESH - %s (%lu ms), full/static/ambient %llu/%llu/%llu ms, frames %lu/%lu/%lu, %lu switches, %lu boosts",
+             refresh_governor_level_name(level), (unsigned long)refresh.period_ms,
+             (unsigned long long)(refresh.dwell_us[REFRESH_FULL] / 1000),
+             (unsigned long long)(refresh.dwell_us[REFRESH_STATIC] / 1000),
+             (unsigned long long)(refresh.dwell_us[REFRESH_AMBIENT] / 1000),
+             (unsigned long)refresh.frames[REFRESH_FULL], (unsigned long)refresh.frames[REFRESH_STATIC],
+             (unsigned long)refresh.frames[REFRESH_AMBIENT], (unsigned long)refresh.switches,
+             (unsigned long)refresh.boosts);
+    refresh_governor_reset_stats();
+}
+
+void refresh_governor_init(lv_display_t *disp) {
+    gov_disp = disp;
+    level = REFRESH_FULL;
+    memset(ambient, 0, sizeof(ambient));
+    last_motion_us = last_change_us = esp_timer_get_time();
+    flush_scheduler_stats_t fs;
+    flush_scheduler_get_stats(&fs);
+    last_frames = fs.frames;
+    refresh_governor_reset_stats();
+    perf_metrics_add_report(report);
+
+#if REFRESH_GOVERNOR
+    lv_timer_set_period(lv_display_get_refr_timer(disp), REFRESH_FULL_MS);
+    lv_display_add_event_cb(disp, invalidate_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    ESP_LOGI(TAG, "Refresh %d/%d/%d ms (full/static/ambient), full for %d ms after motion",
+             REFRESH_FULL_MS, REFRESH_STATIC_MS, REFRESH_AMBIENT_MS, REFRESH_HOLD_MS);
+#else
+    ESP_LOGI(TAG, "Refresh governor disabled, fixed %d ms", LV_DEF_REFR_PERIOD);
+#endif
+}
+
+void refresh_governor_add_ambient(lv_obj_t *obj) {
+    for (int i = 0; i < REFRESH_AMBIENT_MAX; i++) {
+        if (!ambient[i]) {
+            ambient[i] = obj;
+            lv_obj_add_event_cb(obj, ambient_delete_cb, LV_EVENT_DELETE, NULL);
+            return;
+        }
+    }
+    ESP_LOGW(TAG, "No room for another ambient object (REFRESH_AMBIENT_MAX %d)", REFRESH_AMBIENT_MAX);
+}
+
+void refresh_governor_boost() {
+#if REFRESH_GOVERNOR
+    if (!gov_disp) return;
+    last_motion_us = esp_timer_get_time();
+    if (level != REFRESH_FULL) {
+        stats.boosts++;
+        set_level(REFRESH_FULL);
+    }
+#endif
+}
+
+void refresh_governor_update() {
+#if REFRESH_GOVERNOR
+    if (!gov_disp) return;
+    int64_t now = esp_timer_get_time();
+
+    // Frames flushed since the last update ran at the rate chosen then
+    flush_scheduler_stats_t fs;
+    flush_scheduler_get_stats(&fs);
+    stats.frames[level] += fs.frames - last_frames;
+    last_frames = fs.frames;
+
+    bool motion = lv_anim_count_running() > 0;
+    if (indev) {
+        motion = motion || lv_indev_get_state(indev) == LV_INDEV_STATE_PRESSED ||
+                 lv_indev_get_scroll_obj(indev) != NULL;
+    }
+    if (motion) last_motion_us = now;
+
+    if (now - last_motion_us < (int64_t)REFRESH_HOLD_MS * 1000) {
+        set_level(REFRESH_FULL);
+    } else if (now - last_change_us < (int64_t)REFRESH_AMBIENT_AFTER_MS * 1000) {
+        set_level(REFRESH_STATIC);
+    } else {
+        set_level(REFRESH_AMBIENT);
+    }
+#endif
+}
+
+refresh_level_t refresh_governor_get_level() {
+    return level;
+}
+
+uint32_t refresh_governor_get_period_ms() {
+#if REFRESH_GOVERNOR
+    return level_period_ms[level];
+#else
+    return LV_DEF_REFR_PERIOD;
+#endif
+}
+
+const char* refresh_governor_level_name(refresh_level_t l) {
+    return l < REFRESH_LEVEL_COUNT ? level_names[l] : "?";
+}
+
+void refresh_governor_get_stats(refresh_governor_stats_t *out) {
+    if (!out) return;
+    account(esp_timer_get_time());
+    *out = stats;
+    out->period_ms = refresh_governor_get_period_ms();
+}
+
+void refresh_governor_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+    level_since_us = esp_timer_get_time();
+}
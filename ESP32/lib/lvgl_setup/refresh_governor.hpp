@@ -0,0 +1,97 @@
+#ifndef REFRESH_GOVERNOR_HPP
+#define REFRESH_GOVERNOR_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+
+/**
+ * Adaptive refresh rate
+ *
+ * LVGL redraws at most once per period of the display's refresh timer
+ * (LV_DEF_REFR_PERIOD). The governor sets that period from what happens on
+ * screen, after every lv_timer_handler():
+ *
+ *   FULL     an animation runs, the pen is down or a scroll still coasts,
+ *            and for REFRESH_HOLD_MS after the last of them
+ *   STATIC   something else changed within REFRESH_AMBIENT_AFTER_MS
+ *            (a label set by the app, a switch that finished moving)
+ *   AMBIENT  nothing changed but ambient objects, such as the FPS label
+ *            updated once a second
+ *
+ * Every touch sample boosts to FULL from the read callback, before the
+ * refresh timer runs in the same lv_timer_handler(), so input is never
+ * drawn at a slower rate. A slower rate also means fewer timer wakeups
+ * of the LVGL task while the screen is idle.
+ *
+ * The periods are build flags: shorter ones buy smoothness with CPU and
+ * bus time. The dwell time and frames per rate are in the stats.
+ */
+
+// 0 = LVGL's fixed refresh period
+#ifndef REFRESH_GOVERNOR
+#define REFRESH_GOVERNOR 1
+#endif
+
+#ifndef REFRESH_FULL_MS
+#define REFRESH_FULL_MS LV_DEF_REFR_PERIOD
+#endif
+
+#ifndef REFRESH_STATIC_MS
+#define REFRESH_STATIC_MS 100
+#endif
+
+#ifndef REFRESH_AMBIENT_MS
+#define REFRESH_AMBIENT_MS 500
+#endif
+
+// Full rate lingers this long after motion ends (a fling's last frames, a tap's release)
+#ifndef REFRESH_HOLD_MS
+#define REFRESH_HOLD_MS 300
+#endif
+
+// No change but ambient ones for this long before the lowest rate
+#ifndef REFRESH_AMBIENT_AFTER_MS
+#define REFRESH_AMBIENT_AFTER_MS 1000
+#endif
+
+// Objects whose redraws do not count as a change
+#define REFRESH_AMBIENT_MAX 4
+
+typedef enum {
+    REFRESH_FULL = 0,
+    REFRESH_STATIC,
+    REFRESH_AMBIENT,
+    REFRESH_LEVEL_COUNT
+} refresh_level_t;
+
+typedef struct {
+    uint32_t period_ms;                     // Refresh period now
+    uint64_t dwell_us[REFRESH_LEVEL_COUNT]; // Time spent at each rate
+    uint32_t frames[REFRESH_LEVEL_COUNT];   // Frames flushed at each rate
+    uint32_t switches;                      // Rate changes
+    uint32_t boosts;                        // Touch samples that found a lower rate
+    uint32_t ambient_invalidations;         // Redraws of ambient objects, not counted as a change
+} refresh_governor_stats_t;
+
+// Hook the display's invalidations (call after init_lvgl_display)
+void refresh_governor_init(lv_display_t *disp);
+
+// Redraws inside this object's area do not hold the rate up (removed when the object is deleted)
+void refresh_governor_add_ambient(lv_obj_t *obj);
+
+// Input: full rate now (read callback)
+void refresh_governor_boost();
+
+// Pick the rate from what the last lv_timer_handler() did (LVGL task, under lv_lock())
+void refresh_governor_update();
+
+refresh_level_t refresh_governor_get_level();
+
+// Refresh period in effect now
+uint32_t refresh_governor_get_period_ms();
+const char* refresh_governor_level_name(refresh_level_t level);
+
+void refresh_governor_get_stats(refresh_governor_stats_t *stats);
+void refresh_governor_reset_stats();
+
+#endif // REFRESH_GOVERNOR_HPP
@@ -0,0 +1,237 @@
+#include "shadow_fb.hpp"
+#include "flush_encoder.hpp"
+#include "display.hpp"
+#include "bus_arbiter.hpp"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char* TAG = "SHADOW_FB";
+
+static int active_mode = FLUSH_SHADOW_OFF;
+static int32_t shadow_w = 0;
+static int32_t shadow_h = 0;
+static int32_t tile_px = 0;             // Hash tile width (the line with SHADOW_HASH_TILE_PX 0)
+static int32_t tiles_per_row = 0;
+static flush_px_t *shadow_copy = NULL;   // FLUSH_SHADOW_COPY
+static uint32_t *tile_hash = NULL;     // FLUSH_SHADOW_HASH (0 = unknown)
+static shadow_fb_stats_t stats;
+
+static uint32_t hash_pixels(const flush_px_t *px, int32_t n) {
+    uint32_t h = 2166136261u;  // FNV-1a over whole pixels
+    for (int32_t i = 0; i < n; i++) {
+        h = (h ^ flush_px_color(px[i])) * 16777619u;
+    }
+    return h ? h : 1;  // Keep 0 free for "unknown"
+}
+
+static void clear_shadow() {
+    int32_t max_dim = shadow_w > shadow_h ? shadow_w : shadow_h;
+    // A line tile follows the rotation, so full-width rows stay fully covered
+    tile_px = SHADOW_HASH_TILE_PX ? SHADOW_HASH_TILE_PX : shadow_w;
+    tiles_per_row = SHADOW_HASH_TILE_PX ? (max_dim + tile_px - 1) / tile_px : 1;
+
+    if (shadow_copy) {
+        // Matches a black panel
+        memset(shadow_copy, 0, (size_t)shadow_w * shadow_h * sizeof(flush_px_t));
+    }
+    if (tile_hash) {
+        memset(tile_hash, 0, (size_t)tiles_per_row * max_dim * sizeof(uint32_t));
+    }
+}
+
+#if SHADOW_HASH_RESYNC_MS
+// A hash collision leaves a stale tile on the panel; a full flush repairs it
+static void resync_timer_cb(lv_timer_t *timer) {
+    (void)timer;
+    shadow_fb_invalidate();
+}
+#endif
+
+void shadow_fb_init(int32_t hor_res, int32_t ver_res) {
+    shadow_w = hor_res;
+    shadow_h = ver_res;
+    active_mode = FLUSH_SHADOW_MODE;
+
+    if (active_mode == FLUSH_SHADOW_COPY) {
+        size_t size = (size_t)hor_res * ver_res * sizeof(flush_px_t);
+        shadow_copy = (flush_px_t*)heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        if (!shadow_copy) {
+            shadow_copy = (flush_px_t*)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+        }
+        if (!shadow_copy) {
+            ESP_LOGW(TAG, "No room for a %u KB shadow copy, using tile hashes", (unsigned)(size / 1024));
+            active_mode = FLUSH_SHADOW_HASH;
+        }
+    }
+
+    if (active_mode == FLUSH_SHADOW_HASH) {
+        // Sized for the larger dimension so a rotation does not need a new table
+        int32_t max_dim = hor_res > ver_res ? hor_res : ver_res;
+#if SHADOW_HASH_TILE_PX
+        int32_t max_tiles = (max_dim + SHADOW_HASH_TILE_PX - 1) / SHADOW_HASH_TILE_PX;
+#else
+        int32_t max_tiles = 1;  // One hash per line
+#endif
+        size_t size = (size_t)max_tiles * max_dim * sizeof(uint32_t);
+        tile_hash = (uint32_t*)heap_caps_malloc(size, MALLOC_CAP_8BIT);
+        if (!tile_hash) {
+            ESP_LOGE(TAG, "Failed to allocate %u KB tile hash table, delta flushing disabled",
+                     (unsigned)(size / 1024));
+            active_mode = FLUSH_SHADOW_OFF;
+        }
+    }
+
+    // The panel was cleared to black by init_display()
+    clear_shadow();
+    shadow_fb_reset_stats();
+
+#if SHADOW_HASH_RESYNC_MS
+    if (active_mode == FLUSH_SHADOW_HASH) {
+        lv_timer_create(resync_timer_cb, SHADOW_HASH_RESYNC_MS, NULL);
+        ESP_LOGI(TAG, "Full flush every %d ms against hash collisions", SHADOW_HASH_RESYNC_MS);
+    }
+#endif
+
+    ESP_LOGI(TAG, "Delta flushing: %s",
+             active_mode == FLUSH_SHADOW_COPY ? "full copy" :
+             active_mode == FLUSH_SHADOW_HASH ? "tile hashes" : "off");
+}
+
+void shadow_fb_set_resolution(int32_t hor_res, int32_t ver_res) {
+    shadow_w = hor_res;
+    shadow_h = ver_res;
+    shadow_fb_invalidate();
+}
+
+int shadow_fb_get_mode() {
+    return active_mode;
+}
+
+void shadow_fb_invalidate() {
+    if (active_mode == FLUSH_SHADOW_COPY) {
+        // A copy cannot express "unknown" and the panel cannot be read back,
+        // so bring both to a known state: black panel, black copy
+        bus_arbiter_acquire(BUS_CLIENT_DISPLAY, UINT32_MAX);
+        gfx.fillScreen(0x0000);
+        bus_arbiter_release(BUS_CLIENT_DISPLAY);
+    }
+    clear_shadow();
+
+    // Repaint everything on the next refresh
+    lv_display_t *d = lv_display_get_default();
+    if (d) lv_obj_invalidate(lv_display_get_screen_active(d));
+}
+
+/**
+ * Compare one row segment with the shadow and update it
+ *
+ * @return true if anything changed; [first, last] is the changed span (screen x)
+ */
+static bool diff_row(const flush_px_t *row, int32_t x1, int32_t w, int32_t y, int32_t *first, int32_t *last) {
+    int32_t lo = -1;
+    int32_t hi = -1;
+
+    if (active_mode == FLUSH_SHADOW_COPY) {
+        flush_px_t *shadow_row = shadow_copy + (size_t)y * shadow_w + x1;
+        for (int32_t i = 0; i < w; i++) {
+            if (row[i] != shadow_row[i]) {
+                if (lo < 0) lo = i;
+                hi = i;
+            }
+        }
+        if (lo >= 0) {
+            memcpy(shadow_row + lo, row + lo, (size_t)(hi - lo + 1) * sizeof(flush_px_t));
+        }
+    } else {
+        uint32_t *hashes = tile_hash + (size_t)y * tiles_per_row;
+        int32_t x2 = x1 + w - 1;
+
+        for (int32_t t = x1 / tile_px; t <= x2 / tile_px; t++) {
+            int32_t tx1 = t * tile_px;
+            int32_t tx2 = tx1 + tile_px - 1;
+            int32_t sx1 = tx1 > x1 ? tx1 : x1;
+            int32_t sx2 = tx2 < x2 ? tx2 : x2;
+            bool changed;
+
+            if (sx1 == tx1 && sx2 == tx2) {
+                uint32_t h = hash_pixels(row + (sx1 - x1), tile_px);
+                changed = (h != hashes[t]);
+                hashes[t] = h;
+            } else {
+                // Partly covered tile: its other pixels are unknown, so always send
+                changed = true;
+                hashes[t] = 0;
+            }
+
+            if (changed) {
+                if (lo < 0) lo = sx1 - x1;
+                hi = sx2 - x1;
+            }
+        }
+    }
+
+    if (lo < 0) return false;
+    *first = x1 + lo;
+    *last = x1 + hi;
+    return true;
+}
+
+static void send_block(int32_t first, int32_t last, int32_t y1, int32_t y2,
+                       const lv_area_t *area, const flush_px_t *px, int32_t stride, bool use_dma) {
+    lv_area_t block = {first, y1, last, y2};
+    const flush_px_t *block_px = px + (size_t)(y1 - area->y1) * stride + (first - area->x1);
+    flush_encoder_write(&block, block_px, stride, use_dma);
+}
+
+void shadow_fb_write(const lv_area_t *area, const flush_px_t *px, int32_t stride, bool use_dma) {
+    if (active_mode == FLUSH_SHADOW_OFF) {
+        flush_encoder_write(area, px, stride, use_dma);
+        return;
+    }
+
+    const int32_t w = area->x2 - area->x1 + 1;
+
+    // Pending block of consecutive changed rows sharing one span
+    int32_t block_y = -1;
+    int32_t block_first = 0;
+    int32_t block_last = 0;
+
+    for (int32_t y = area->y1; y <= area->y2; y++) {
+        const flush_px_t *row = px + (size_t)(y - area->y1) * stride;
+        int32_t first, last;
+        bool changed = diff_row(row, area->x1, w, y, &first, &last);
+
+        if (changed) {
+            stats.rows_sent++;
+            stats.bytes_sent += (uint64_t)(last - first + 1) * TFT_WIRE_BYTES_PER_PIXEL;
+            stats.bytes_skipped += (uint64_t)(w - (last - first + 1)) * TFT_WIRE_BYTES_PER_PIXEL;
+        } else {
+            stats.rows_skipped++;
+            stats.bytes_skipped += (uint64_t)w * TFT_WIRE_BYTES_PER_PIXEL;
+        }
+
+        // Close the pending block when the span changes or the row is clean
+        if (block_y >= 0 && (!changed || first != block_first || last != block_last)) {
+            send_block(block_first, block_last, block_y, y - 1, area, px, stride, use_dma);
+            block_y = -1;
+        }
+        if (changed && block_y < 0) {
+            block_y = y;
+            block_first = first;
+            block_last = last;
+        }
+    }
+
+    if (block_y >= 0) {
+        send_block(block_first, block_last, block_y, area->y2, area, px, stride, use_dma);
+    }
+}
+
+void shadow_fb_get_stats(shadow_fb_stats_t *out) {
+    if (out) *out = stats;
+}
+
+void shadow_fb_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+}
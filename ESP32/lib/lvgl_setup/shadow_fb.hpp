@@ -0,0 +1,95 @@
+#ifndef SHADOW_FB_HPP
+#define SHADOW_FB_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+#include "flush_pixel.hpp"
+
+/**
+ * Shadow framebuffer for delta flushing
+ *
+ * Remembers what is already on the panel and drops rows of a flushed area
+ * that did not change. Many invalidations repaint identical pixels (a theme
+ * refresh invalidating the whole screen, lv_label_set_text with the same
+ * value), and those rows never reach the bus.
+ *
+ * Changed rows are trimmed to their first..last changed pixel, and runs of
+ * rows with the same span are sent as one window through the flush encoder.
+ *
+ * HASH mode trusts a 32-bit FNV-1a hash per tile: a tile that changed but
+ * hashes to its old value is silently not sent, and stays wrong on the panel
+ * until it changes again (about 1 in 2^32 per changed tile). Where that
+ * matters, SHADOW_HASH_RESYNC_MS forces a full flush periodically, or COPY
+ * mode compares the pixels themselves.
+ */
+
+#define FLUSH_SHADOW_OFF  0  // Send every flushed area as-is
+#define FLUSH_SHADOW_COPY 1  // Full copy of the panel (PSRAM when available, 300 KB at 16-bit)
+#define FLUSH_SHADOW_HASH 2  // 32-bit hash per line (~1.9 KB) or per row tile (SHADOW_HASH_TILE_PX)
+
+#ifndef FLUSH_SHADOW_MODE
+#define FLUSH_SHADOW_MODE FLUSH_SHADOW_OFF
+#endif
+
+// Tile width of the hash table in pixels, 0 for one hash per line. The
+// table has a row of tiles per line of the longer side, so either rotation
+// fits: 480 x 4 bytes (1.9 KB) per line, 480 x 30 tiles x 4 bytes (57.6 KB)
+// with 16 px tiles on the ILI9488. A line hash only skips lines an area
+// covers edge to edge; narrower tiles also skip parts of narrower areas
+// and trim changed spans, at the cost of internal RAM.
+#ifndef SHADOW_HASH_TILE_PX
+#define SHADOW_HASH_TILE_PX 0
+#endif
+
+// HASH mode: forget the hashes and send the whole screen this often (0 = never)
+#ifndef SHADOW_HASH_RESYNC_MS
+#define SHADOW_HASH_RESYNC_MS 0
+#endif
+
+typedef struct {
+    uint64_t bytes_sent;       // Wire bytes of rows that changed
+    uint64_t bytes_skipped;    // Wire bytes of rows/columns found identical
+    uint32_t rows_sent;
+    uint32_t rows_skipped;
+} shadow_fb_stats_t;
+
+/**
+ * Allocate the shadow for a hor x ver panel
+ *
+ * FLUSH_SHADOW_COPY falls back to the hash table when the full copy cannot
+ * be allocated. The shadow starts out matching a black panel.
+ */
+void shadow_fb_init(int32_t hor_res, int32_t ver_res);
+
+/**
+ * Follow a panel rotation: same pixel count, swapped dimensions
+ *
+ * The buffers allocated by shadow_fb_init() fit both orientations. The
+ * shadow is invalidated because the panel content is about to be redrawn.
+ */
+void shadow_fb_set_resolution(int32_t hor_res, int32_t ver_res);
+
+// Mode actually in use after allocation
+int shadow_fb_get_mode();
+
+/**
+ * Forget the panel contents (e.g. after a rotation or a direct panel write)
+ *
+ * Call between frames, with no flush in flight. In copy mode the panel is
+ * cleared to black under the bus arbiter (taken recursively if the caller
+ * holds it); the active screen is invalidated in both modes.
+ */
+void shadow_fb_invalidate();
+
+/**
+ * Send the changed part of an area through the flush encoder
+ *
+ * Same parameters as flush_encoder_write(). With the shadow disabled this
+ * is a plain flush_encoder_write() call.
+ */
+void shadow_fb_write(const lv_area_t *area, const flush_px_t *px, int32_t stride, bool use_dma);
+
+void shadow_fb_get_stats(shadow_fb_stats_t *stats);
+void shadow_fb_reset_stats();
+
+#endif // SHADOW_FB_HPP
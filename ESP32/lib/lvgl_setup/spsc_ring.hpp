@@ -0,0 +1,49 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * Lock-free single-producer / single-consumer ring
+ *
+ * One task pushes, another pops, neither ever blocks or disables
+ * interrupts. Each index is written by one side only; the release store
+ * publishes the slot, the other side's acquire load sees it. Capacity is
+ * N - 1 entries, N must be a power of two.
+ */
+template <typename T, uint32_t N>
+class spsc_ring {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "spsc_ring size must be a power of two");
+
+    T slots[N];
+    std::atomic<uint32_t> head{0};  // Next slot to write, producer only
+    std::atomic<uint32_t> tail{0};  // Next slot to read, consumer only
+
+public:
+    // Producer side; false when full (the item is dropped)
+    bool push(const T &item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        uint32_t next = (h + 1) & (N - 1);
+        if (next == tail.load(std::memory_order_acquire)) return false;
+        slots[h] = item;
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; false when empty
+    bool pop(T *item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return false;
+        *item = slots[t];
+        tail.store((t + 1) & (N - 1), std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool empty() const {
+        return tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire);
+    }
+};
+
+#endif // SPSC_RING_HPP
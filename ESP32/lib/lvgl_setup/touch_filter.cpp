@@ -0,0 +1,131 @@
+#include "touch_filter.hpp"
+#include "esp_log.h"
+#include <string.h>
+
+static const char* TAG = "TOUCH_FILTER";
+
+static touch_filter_config_t config;   // Set by the application
+static touch_filter_config_t active;   // Latched at the start of each press
+static touch_filter_stats_t stats;
+
+// Per-press state
+static bool pressed = false;
+static int16_t hist_x[TOUCH_FILTER_MEDIAN_MAX];
+static int16_t hist_y[TOUCH_FILTER_MEDIAN_MAX];
+static uint8_t hist_count = 0;
+static uint8_t hist_pos = 0;
+static int32_t iir_x = 0;              // 24.8 fixed point
+static int32_t iir_y = 0;
+static int16_t out_x = 0;
+static int16_t out_y = 0;
+
+// Median of the first n values (n <= TOUCH_FILTER_MEDIAN_MAX)
+static int16_t median_of(const int16_t *values, uint8_t n) {
+    int16_t sorted[TOUCH_FILTER_MEDIAN_MAX];
+    for (uint8_t i = 0; i < n; i++) {
+        int16_t v = values[i];
+        uint8_t j = i;
+        while (j > 0 && sorted[j - 1] > v) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = v;
+    }
+    return sorted[(n - 1) / 2];
+}
+
+// Move the output only once the input leaves the dead-zone, then trail it
+static int16_t deadzone(int16_t out, int16_t in, int16_t zone) {
+    if (in - out > zone) return in - zone;
+    if (out - in > zone) return in + zone;
+    return out;
+}
+
+static void start_press(const touch_sample_t *sample) {
+    pressed = true;
+    active = config;
+    hist_x[0] = sample->x;
+    hist_y[0] = sample->y;
+    hist_count = 1;
+    hist_pos = 1 % active.median;
+    iir_x = (int32_t)sample->x << 8;
+    iir_y = (int32_t)sample->y << 8;
+    out_x = sample->x;
+    out_y = sample->y;
+}
+
+void touch_filter_init() {
+    touch_filter_config_t defaults;
+    defaults.median = TOUCH_FILTER_MEDIAN;
+    defaults.iir_alpha = TOUCH_FILTER_IIR_ALPHA;
+    defaults.deadzone_px = TOUCH_FILTER_DEADZONE_PX;
+    touch_filter_set_config(&defaults);
+    touch_filter_reset_stats();
+    pressed = false;
+}
+
+void touch_filter_set_config(const touch_filter_config_t *new_config) {
+    config = *new_config;
+    if (config.median < 1) config.median = 1;
+    if (config.median > TOUCH_FILTER_MEDIAN_MAX) config.median = TOUCH_FILTER_MEDIAN_MAX;
+    if (config.median % 2 == 0) config.median--;
+    if (config.iir_alpha < 1) config.iir_alpha = 1;
+    if (config.iir_alpha > 256) config.iir_alpha = 256;
+
+    ESP_LOGI(TAG, "Median %u, IIR alpha %u/256, dead-zone %u px",
+             (unsigned)config.median, (unsigned)config.iir_alpha, (unsigned)config.deadzone_px);
+}
+
+void touch_filter_get_config(touch_filter_config_t *out) {
+    *out = config;
+}
+
+void touch_filter_apply(touch_sample_t *sample) {
+    if (!sample->pressed) {
+        // Release where the filtered pointer is, not where the last raw sample was
+        if (pressed) {
+            sample->x = out_x;
+            sample->y = out_y;
+            pressed = false;
+        }
+        return;
+    }
+
+    stats.samples++;
+    if (!pressed) {
+        start_press(sample);
+        return;
+    }
+
+    // 1. Median over the recent raw samples
+    hist_x[hist_pos] = sample->x;
+    hist_y[hist_pos] = sample->y;
+    hist_pos = (hist_pos + 1) % active.median;
+    if (hist_count < active.median) hist_count++;
+    int32_t mx = median_of(hist_x, hist_count);
+    int32_t my = median_of(hist_y, hist_count);
+
+    // 2. Exponential smoothing
+    iir_x += ((mx << 8) - iir_x) * active.iir_alpha / 256;
+    iir_y += ((my << 8) - iir_y) * active.iir_alpha / 256;
+    int16_t fx = (int16_t)((iir_x + 128) >> 8);
+    int16_t fy = (int16_t)((iir_y + 128) >> 8);
+
+    // 3. Dead-zone
+    int16_t nx = deadzone(out_x, fx, active.deadzone_px);
+    int16_t ny = deadzone(out_y, fy, active.deadzone_px);
+    if (nx == out_x && ny == out_y) stats.held++;
+    out_x = nx;
+    out_y = ny;
+
+    sample->x = out_x;
+    sample->y = out_y;
+}
+
+void touch_filter_get_stats(touch_filter_stats_t *out) {
+    if (out) *out = stats;
+}
+
+void touch_filter_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+}
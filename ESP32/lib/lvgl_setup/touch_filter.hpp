@@ -0,0 +1,68 @@
+#ifndef TOUCH_FILTER_HPP
+#define TOUCH_FILTER_HPP
+
+#include <stdint.h>
+#include "touch_sampler.hpp"
+
+/**
+ * Jitter filter between the touch sampler and LVGL
+ *
+ * A resting finger on the resistive XPT2046 wanders by a few pixels. LVGL
+ * takes every wobble as a drag, and on a scrolled tab a one-pixel scroll
+ * redraws the whole content area. Three stages, each optional, run on
+ * every pressed sample in order:
+ *
+ *  1. Median over the last TOUCH_FILTER_MEDIAN raw samples (kills spikes)
+ *  2. Exponential smoothing, new = old + alpha/256 * (in - old)
+ *  3. Dead-zone: the output only follows once the input is more than
+ *     TOUCH_FILTER_DEADZONE_PX away, then trails it by that distance
+ *
+ * The first sample of a press is passed through untouched so taps land
+ * where the finger is; releases keep the last filtered position.
+ */
+
+// Median window in samples, odd (1 = off)
+#ifndef TOUCH_FILTER_MEDIAN
+#define TOUCH_FILTER_MEDIAN 3
+#endif
+#define TOUCH_FILTER_MEDIAN_MAX 7
+
+// Weight of a new sample out of 256 (256 = off)
+#ifndef TOUCH_FILTER_IIR_ALPHA
+#define TOUCH_FILTER_IIR_ALPHA 160
+#endif
+
+// Pixels the input may wander before the output moves (0 = off)
+#ifndef TOUCH_FILTER_DEADZONE_PX
+#define TOUCH_FILTER_DEADZONE_PX 2
+#endif
+
+#if TOUCH_FILTER_MEDIAN < 1 || TOUCH_FILTER_MEDIAN > TOUCH_FILTER_MEDIAN_MAX || (TOUCH_FILTER_MEDIAN % 2) == 0
+#error "TOUCH_FILTER_MEDIAN must be odd, 1 to TOUCH_FILTER_MEDIAN_MAX"
+#endif
+
+typedef struct {
+    uint8_t median;            // Window, odd, 1..TOUCH_FILTER_MEDIAN_MAX
+    uint16_t iir_alpha;        // 1..256
+    uint8_t deadzone_px;
+} touch_filter_config_t;
+
+typedef struct {
+    uint32_t samples;          // Pressed samples filtered
+    uint32_t held;             // Samples whose output did not move (absorbed jitter)
+} touch_filter_stats_t;
+
+// Start from the build-time configuration
+void touch_filter_init();
+
+// Runtime tuning; out-of-range values are clamped. Takes effect on the next press.
+void touch_filter_set_config(const touch_filter_config_t *config);
+void touch_filter_get_config(touch_filter_config_t *config);
+
+// Filter one sample from the ring in place (LVGL task)
+void touch_filter_apply(touch_sample_t *sample);
+
+void touch_filter_get_stats(touch_filter_stats_t *stats);
+void touch_filter_reset_stats();
+
+#endif // TOUCH_FILTER_HPP
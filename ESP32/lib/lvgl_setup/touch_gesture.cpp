@@ -0,0 +1,252 @@
+#include "touch_gesture.hpp"
+#include "esp_log.h"
+#include <string.h>
+
+static const char* TAG = "TOUCH_GESTURE";
+
+typedef struct {
+    lv_obj_t *obj;             // NULL = free slot
+    uint32_t mask;
+    touch_gesture_cb_t cb;
+    void *user_data;
+} subscriber_t;
+
+typedef struct {
+    uint32_t t_ms;             // Since the press
+    int16_t x;
+    int16_t y;
+} history_t;
+
+static subscriber_t subscribers[TOUCH_GESTURE_SUBSCRIBERS_MAX];
+static touch_gesture_stats_t stats;
+
+// Current press
+static bool down = false;
+static int64_t down_us = 0;
+static lv_point_t start_point;
+static lv_point_t last_point;
+static bool moved = false;         // Left the slop circle at some point
+static bool long_fired = false;
+static bool double_candidate = false;
+static history_t history[TOUCH_GESTURE_HISTORY];
+static uint8_t history_count = 0;
+static uint8_t history_pos = 0;
+
+// Previous tap, for double-tap
+static bool tap_pending = false;
+static int64_t tap_up_us = 0;
+static lv_point_t tap_point;
+
+static int32_t abs32(int32_t v) {
+    return v < 0 ? -v : v;
+}
+
+static bool within(const lv_point_t &a, const lv_point_t &b, int32_t radius) {
+    int32_t dx = a.x - b.x;
+    int32_t dy = a.y - b.y;
+    return dx * dx + dy * dy <= radius * radius;
+}
+
+static void push_history(int64_t time_us, int16_t x, int16_t y) {
+    history[history_pos] = {(uint32_t)((time_us - down_us) / 1000), x, y};
+    history_pos = (history_pos + 1) % TOUCH_GESTURE_HISTORY;
+    if (history_count < TOUCH_GESTURE_HISTORY) history_count++;
+}
+
+/**
+ * Least-squares slope of x(t) and y(t) over the samples taken in the
+ * velocity window before end_ms, in px/s. A finger that stopped before
+ * lifting leaves fewer than two samples in the window: velocity 0.
+ */
+static void release_velocity(uint32_t end_ms, int32_t *vx, int32_t *vy) {
+    *vx = 0;
+    *vy = 0;
+    uint32_t from_ms = end_ms > TOUCH_GESTURE_VELOCITY_MS ? end_ms - TOUCH_GESTURE_VELOCITY_MS : 0;
+
+    int64_t n = 0, st = 0, stt = 0, sx = 0, sy = 0, stx = 0, sty = 0;
+    for (uint8_t i = 0; i < history_count; i++) {
+        const history_t &h = history[(history_pos + TOUCH_GESTURE_HISTORY - 1 - i) % TOUCH_GESTURE_HISTORY];
+        if (h.t_ms < from_ms) break;
+        int64_t t = h.t_ms - from_ms;
+        n++;
+        st += t;
+        stt += t * t;
+        sx += h.x;
+        sy += h.y;
+        stx += t * h.x;
+        sty += t * h.y;
+    }
+
+    int64_t den = n * stt - st * st;
+    if (n < 2 || den == 0) return;
+    *vx = (int32_t)(1000 * (n * stx - st * sx) / den);
+    *vy = (int32_t)(1000 * (n * sty - st * sy) / den);
+}
+
+static void emit(touch_gesture_t *gesture) {
+    stats.recognized[gesture->type]++;
+
+    // Innermost subscriber under the press point, looked up now so a press
+    // never holds on to an object that may be deleted before it ends.
+    // Same search order as LVGL's pointer processing.
+    lv_point_t point = start_point;
+    lv_obj_t *target = lv_indev_search_obj(lv_layer_top(), &point);
+    if (!target) target = lv_indev_search_obj(lv_screen_active(), &point);
+
+    for (lv_obj_t *obj = target; obj; obj = lv_obj_get_parent(obj)) {
+        for (uint32_t i = 0; i < TOUCH_GESTURE_SUBSCRIBERS_MAX; i++) {
+            const subscriber_t &s = subscribers[i];
+            if (s.obj != obj || !(s.mask & TOUCH_GESTURE_MASK(gesture->type))) continue;
+            stats.delivered++;
+            s.cb(obj, gesture, s.user_data);
+            return;
+        }
+    }
+}
+
+static void begin_press(const touch_sample_t *sample) {
+    down = true;
+    down_us = sample->time_us;
+    start_point = {sample->x, sample->y};
+    last_point = start_point;
+    moved = false;
+    long_fired = false;
+    double_candidate = tap_pending && sample->time_us - tap_up_us <= TOUCH_GESTURE_DOUBLE_TAP_MS * 1000LL &&
+                       within(tap_point, start_point, TOUCH_GESTURE_DOUBLE_TAP_PX);
+    history_count = 0;
+    history_pos = 0;
+    push_history(sample->time_us, sample->x, sample->y);
+}
+
+static void end_press(const touch_sample_t *sample) {
+    down = false;
+
+    touch_gesture_t gesture;
+    memset(&gesture, 0, sizeof(gesture));
+    gesture.start = start_point;
+    gesture.end = last_point;
+    gesture.duration_ms = (uint32_t)((sample->time_us - down_us) / 1000);
+
+    if (long_fired) {
+        tap_pending = false;
+        return;
+    }
+
+    if (!moved) {
+        if (double_candidate) {
+            gesture.type = TOUCH_GESTURE_DOUBLE_TAP;
+            tap_pending = false;
+        } else {
+            gesture.type = TOUCH_GESTURE_TAP;
+            tap_pending = true;
+            tap_up_us = sample->time_us;
+            tap_point = start_point;
+        }
+        emit(&gesture);
+        return;
+    }
+    tap_pending = false;
+
+    int32_t dx = last_point.x - start_point.x;
+    int32_t dy = last_point.y - start_point.y;
+    bool horizontal = abs32(dx) >= abs32(dy);
+    int32_t major = horizontal ? abs32(dx) : abs32(dy);
+    int32_t minor = horizontal ? abs32(dy) : abs32(dx);
+    if (major < TOUCH_GESTURE_SWIPE_MIN_PX || major < minor * TOUCH_GESTURE_SWIPE_AXIS_RATIO) return;
+
+    if (horizontal) {
+        gesture.dir = dx < 0 ? TOUCH_GESTURE_DIR_LEFT : TOUCH_GESTURE_DIR_RIGHT;
+    } else {
+        gesture.dir = dy < 0 ? TOUCH_GESTURE_DIR_UP : TOUCH_GESTURE_DIR_DOWN;
+    }
+    release_velocity(gesture.duration_ms, &gesture.vx, &gesture.vy);
+
+    // Still moving the same way at release
+    int32_t v = horizontal ? gesture.vx : gesture.vy;
+    int32_t d = horizontal ? dx : dy;
+    bool fling = (v < 0) == (d < 0) && abs32(v) >= TOUCH_GESTURE_FLING_MIN_SPEED;
+    gesture.type = fling ? TOUCH_GESTURE_FLING : TOUCH_GESTURE_SWIPE;
+    emit(&gesture);
+}
+
+static void subscriber_delete_event_cb(lv_event_t *e) {
+    subscriber_t *s = (subscriber_t*)lv_event_get_user_data(e);
+    s->obj = NULL;
+}
+
+void touch_gesture_init() {
+    memset(subscribers, 0, sizeof(subscribers));
+    down = false;
+    tap_pending = false;
+    touch_gesture_reset_stats();
+}
+
+void touch_gesture_subscribe(lv_obj_t *obj, uint32_t mask, touch_gesture_cb_t cb, void *user_data) {
+    if (!obj || !cb) return;
+
+    for (uint32_t i = 0; i < TOUCH_GESTURE_SUBSCRIBERS_MAX; i++) {
+        subscriber_t &s = subscribers[i];
+        if (s.obj) continue;
+        s = {obj, mask, cb, user_data};
+        lv_obj_add_event_cb(obj, subscriber_delete_event_cb, LV_EVENT_DELETE, &s);
+        return;
+    }
+    ESP_LOGW(TAG, "No free subscriber slot (TOUCH_GESTURE_SUBSCRIBERS_MAX %d)", TOUCH_GESTURE_SUBSCRIBERS_MAX);
+}
+
+void touch_gesture_unsubscribe(lv_obj_t *obj) {
+    for (uint32_t i = 0; i < TOUCH_GESTURE_SUBSCRIBERS_MAX; i++) {
+        subscriber_t &s = subscribers[i];
+        if (s.obj != obj) continue;
+        lv_obj_remove_event_cb_with_user_data(obj, subscriber_delete_event_cb, &s);
+        s.obj = NULL;
+    }
+}
+
+void touch_gesture_feed(const touch_sample_t *sample) {
+    if (!sample->pressed) {
+        if (down) end_press(sample);
+        return;
+    }
+    if (!down) {
+        begin_press(sample);
+        return;
+    }
+
+    last_point = {sample->x, sample->y};
+    if (!moved && !within(start_point, last_point, TOUCH_GESTURE_SLOP_PX)) moved = true;
+    push_history(sample->time_us, sample->x, sample->y);
+}
+
+void touch_gesture_tick(int64_t now_us) {
+    if (!down || moved || long_fired) return;
+    if (now_us - down_us < TOUCH_GESTURE_LONG_PRESS_MS * 1000LL) return;
+
+    long_fired = true;
+    touch_gesture_t gesture;
+    memset(&gesture, 0, sizeof(gesture));
+    gesture.type = TOUCH_GESTURE_LONG_PRESS;
+    gesture.start = start_point;
+    gesture.end = last_point;
+    gesture.duration_ms = (uint32_t)((now_us - down_us) / 1000);
+    emit(&gesture);
+}
+
+const char* touch_gesture_type_name(touch_gesture_type_t type) {
+    switch (type) {
+        case TOUCH_GESTURE_TAP:        return "tap";
+        case TOUCH_GESTURE_DOUBLE_TAP: return "double_tap";
+        case TOUCH_GESTURE_LONG_PRESS: return "long_press";
+        case TOUCH_GESTURE_SWIPE:      return "swipe";
+        case TOUCH_GESTURE_FLING:      return "fling";
+        default:                       return "unknown";
+    }
+}
+
+void touch_gesture_get_stats(touch_gesture_stats_t *out) {
+    if (out) *out = stats;
+}
+
+void touch_gesture_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+}
@@ -0,0 +1,127 @@
+#ifndef TOUCH_GESTURE_HPP
+#define TOUCH_GESTURE_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+#include "touch_sampler.hpp"
+
+/**
+ * Gesture recognizer on the pointer stream
+ *
+ * Classifies the points handed to LVGL into tap, double-tap, long-press,
+ * swipe and fling, so widgets subscribe to finished gestures instead of
+ * re-deriving motion from LV_EVENT_PRESSING. All math is integer: the
+ * release velocity is a least-squares slope over the samples of the last
+ * TOUCH_GESTURE_VELOCITY_MS, kept in a TOUCH_GESTURE_HISTORY entry ring.
+ *
+ * A gesture goes to the innermost subscribed object under the point where
+ * the press started, if it subscribed to that gesture type. Callbacks run
+ * in the LVGL task from the indev read, before LVGL processes the point:
+ * they may change the UI but must not delete the pressed object.
+ *
+ * LVGL's own events still fire: a tap is also a click, a swipe over a
+ * scrollable object also scrolls it in the directions it allows.
+ */
+
+// Movement from the press point that still counts as holding still
+#ifndef TOUCH_GESTURE_SLOP_PX
+#define TOUCH_GESTURE_SLOP_PX 10
+#endif
+
+#ifndef TOUCH_GESTURE_LONG_PRESS_MS
+#define TOUCH_GESTURE_LONG_PRESS_MS 500
+#endif
+
+// Second tap must start within this time and distance of the first one's release
+#ifndef TOUCH_GESTURE_DOUBLE_TAP_MS
+#define TOUCH_GESTURE_DOUBLE_TAP_MS 300
+#endif
+#ifndef TOUCH_GESTURE_DOUBLE_TAP_PX
+#define TOUCH_GESTURE_DOUBLE_TAP_PX 30
+#endif
+
+// Swipe: travel along the dominant axis, at least RATIO times the other axis
+#ifndef TOUCH_GESTURE_SWIPE_MIN_PX
+#define TOUCH_GESTURE_SWIPE_MIN_PX 40
+#endif
+#ifndef TOUCH_GESTURE_SWIPE_AXIS_RATIO
+#define TOUCH_GESTURE_SWIPE_AXIS_RATIO 2
+#endif
+
+// A swipe still this fast at release (px/s) is a fling
+#ifndef TOUCH_GESTURE_FLING_MIN_SPEED
+#define TOUCH_GESTURE_FLING_MIN_SPEED 600
+#endif
+
+// Release velocity window and sample history
+#ifndef TOUCH_GESTURE_VELOCITY_MS
+#define TOUCH_GESTURE_VELOCITY_MS 80
+#endif
+#ifndef TOUCH_GESTURE_HISTORY
+#define TOUCH_GESTURE_HISTORY 8
+#endif
+
+// Subscriptions at the same time
+#ifndef TOUCH_GESTURE_SUBSCRIBERS_MAX
+#define TOUCH_GESTURE_SUBSCRIBERS_MAX 8
+#endif
+
+typedef enum {
+    TOUCH_GESTURE_TAP,
+    TOUCH_GESTURE_DOUBLE_TAP,  // Instead of the second tap
+    TOUCH_GESTURE_LONG_PRESS,  // While still pressed; the release then ends nothing
+    TOUCH_GESTURE_SWIPE,
+    TOUCH_GESTURE_FLING,       // A swipe released at TOUCH_GESTURE_FLING_MIN_SPEED or more
+    TOUCH_GESTURE_TYPE_COUNT
+} touch_gesture_type_t;
+
+#define TOUCH_GESTURE_MASK(type) (1u << (type))
+#define TOUCH_GESTURE_MASK_SWIPES (TOUCH_GESTURE_MASK(TOUCH_GESTURE_SWIPE) | TOUCH_GESTURE_MASK(TOUCH_GESTURE_FLING))
+
+typedef enum {
+    TOUCH_GESTURE_DIR_NONE,
+    TOUCH_GESTURE_DIR_LEFT,    // Finger moved towards smaller x
+    TOUCH_GESTURE_DIR_RIGHT,
+    TOUCH_GESTURE_DIR_UP,
+    TOUCH_GESTURE_DIR_DOWN
+} touch_gesture_dir_t;
+
+typedef struct {
+    touch_gesture_type_t type;
+    touch_gesture_dir_t dir;   // Swipe and fling only
+    lv_point_t start;          // Press point
+    lv_point_t end;            // Last point (current point for a long press)
+    int32_t vx;                // Release velocity in px/s (swipe and fling)
+    int32_t vy;
+    uint32_t duration_ms;      // Press to release (to recognition for a long press)
+} touch_gesture_t;
+
+typedef void (*touch_gesture_cb_t)(lv_obj_t *obj, const touch_gesture_t *gesture, void *user_data);
+
+typedef struct {
+    uint32_t recognized[TOUCH_GESTURE_TYPE_COUNT];
+    uint32_t delivered;        // Gestures that reached a subscriber
+} touch_gesture_stats_t;
+
+void touch_gesture_init();
+
+/**
+ * Deliver the gesture types in mask that start on obj or its children (LVGL task)
+ *
+ * The subscription ends when obj is deleted.
+ */
+void touch_gesture_subscribe(lv_obj_t *obj, uint32_t mask, touch_gesture_cb_t cb, void *user_data);
+void touch_gesture_unsubscribe(lv_obj_t *obj);
+
+// Feed each new point handed to LVGL, with the time it was sampled
+void touch_gesture_feed(const touch_sample_t *sample);
+
+// Call on every indev read; recognizes a long press while no new points arrive
+void touch_gesture_tick(int64_t now_us);
+
+const char* touch_gesture_type_name(touch_gesture_type_t type);
+
+void touch_gesture_get_stats(touch_gesture_stats_t *stats);
+void touch_gesture_reset_stats();
+
+#endif // TOUCH_GESTURE_HPP
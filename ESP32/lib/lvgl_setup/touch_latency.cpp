@@ -0,0 +1,220 @@
+#include "touch_latency.hpp"
+#include "perf_metrics.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char* TAG = "TOUCH_LATENCY";
+
+static const uint16_t bucket_limit_ms[TOUCH_LATENCY_BUCKETS - 1] = {16, 33, 50, 66, 100, 150, 250, 500};
+
+typedef struct {
+    bool used;
+    lv_obj_t *affected;
+    touch_latency_kind_t kind;
+} trigger_t;
+
+typedef struct {
+    touch_latency_kind_t kind;
+    bool whole_screen;
+    lv_area_t area;            // Affected area at click time
+    bool covered;              // A flush over the area started after the click
+    int64_t sample_us;
+    int64_t event_us;
+    int64_t flush_start_us;
+} pending_t;
+
+typedef struct {
+    touch_latency_stats_t stats;
+    uint64_t total_sum_us;
+    uint64_t dispatch_sum_us;
+    uint64_t render_sum_us;
+    uint64_t flush_sum_us;
+} kind_acc_t;
+
+static trigger_t triggers[TOUCH_LATENCY_TRIGGERS_MAX];
+static pending_t pending[TOUCH_LATENCY_PENDING_MAX];
+static uint8_t pending_count = 0;
+static kind_acc_t acc[TOUCH_LATENCY_KIND_COUNT];
+
+static int64_t last_sample_us = 0;
+
+static void remove_pending(uint8_t index) {
+    memmove(&pending[index], &pending[index + 1], sizeof(pending_t) * (pending_count - index - 1));
+    pending_count--;
+}
+
+static void expire_pending(int64_t now) {
+    for (uint8_t i = 0; i < pending_count;) {
+        if (now - pending[i].event_us > (int64_t)TOUCH_LATENCY_TIMEOUT_MS * 1000) {
+            acc[pending[i].kind].stats.timeouts++;
+            remove_pending(i);
+        } else {
+            i++;
+        }
+    }
+}
+
+static void record(const pending_t &p, int64_t now) {
+    kind_acc_t &a = acc[p.kind];
+    uint32_t total = (uint32_t)(now - p.sample_us);
+
+    uint8_t bucket = 0;
+    while (bucket < TOUCH_LATENCY_BUCKETS - 1 && total >= bucket_limit_ms[bucket] * 1000u) bucket++;
+    a.stats.buckets[bucket]++;
+    perf_metrics_record(PERF_INPUT_LATENCY, total);
+
+    a.stats.count++;
+    if (total > a.stats.total_max_us) a.stats.total_max_us = total;
+    a.total_sum_us += total;
+    a.dispatch_sum_us += (uint64_t)(p.event_us - p.sample_us);
+    a.render_sum_us += (uint64_t)(p.flush_start_us - p.event_us);
+    a.flush_sum_us += (uint64_t)(now - p.flush_start_us);
+}
+
+static void click_event_cb(lv_event_t *e) {
+    const trigger_t *trigger = (const trigger_t*)lv_event_get_user_data(e);
+    int64_t now = esp_timer_get_time();
+    expire_pending(now);
+
+    if (pending_count == TOUCH_LATENCY_PENDING_MAX) {
+        acc[pending[0].kind].stats.timeouts++;
+        remove_pending(0);
+    }
+
+    pending_t &p = pending[pending_count++];
+    p.kind = trigger->kind;
+    p.whole_screen = trigger->affected == NULL;
+    if (trigger->affected) lv_obj_get_coords(trigger->affected, &p.area);
+    p.covered = false;
+    // Clicks not caused by a touch (e.g. lv_obj_send_event) start at dispatch
+    p.sample_us = last_sample_us && last_sample_us <= now ? last_sample_us : now;
+    p.event_us = now;
+    p.flush_start_us = 0;
+}
+
+static void trigger_delete_event_cb(lv_event_t *e) {
+    trigger_t *trigger = (trigger_t*)lv_event_get_user_data(e);
+    trigger->used = false;
+}
+
+// Touch-to-photon latency of the interactions used since the last report
+static void report() {
+    for (int k = 0; k < TOUCH_LATENCY_KIND_COUNT; k++) {
+        touch_latency_stats_t lat;
+        touch_latency_get_stats((touch_latency_kind_t)k, &lat);
+        if (lat.count == 0 && lat.timeouts == 0) continue;
+
+        char hist[96];
+        int len = 0;
+        for (int b = 0; b < TOUCH_LATENCY_BUCKETS && len < (int)sizeof(hist); b++) {
+            uint32_t limit = touch_latency_bucket_limit_ms(b);
+            if (limit) {
+                len += snprintf(hist + len, sizeof(hist) - len, "<%lu:%lu ",
+                                (unsigned long)limit, (unsigned long)lat.buckets[b]);
+            } else {
+                len += snprintf(hist + len, sizeof(hist) - len, ">=%lu:%lu",
+                                (unsigned long)touch_latency_bucket_limit_ms(b - 1), (unsigned long)lat.buckets[b]);
+            }
+        }
+        ESP_LOGI(TAG, "LATENCY %s - %lu clicks, avg %lu ms (max %lu), dispatch %lu us, render %lu us, flush %lu us, timeouts %lu | %s",
+                 touch_latency_kind_name((touch_latency_kind_t)k), (unsigned long)lat.count,
+                 (unsigned long)(lat.total_avg_us / 1000), (unsigned long)(lat.total_max_us / 1000),
+                 (unsigned long)lat.dispatch_avg_us, (unsigned long)lat.render_avg_us,
+                 (unsigned long)lat.flush_avg_us, (unsigned long)lat.timeouts, hist);
+    }
+    touch_latency_reset_stats();
+}
+
+void touch_latency_init() {
+    memset(triggers, 0, sizeof(triggers));
+    pending_count = 0;
+    last_sample_us = 0;
+    touch_latency_reset_stats();
+    perf_metrics_add_report(report);
+}
+
+void touch_latency_track(lv_obj_t *trigger, lv_obj_t *affected, touch_latency_kind_t kind) {
+    if (!trigger || kind >= TOUCH_LATENCY_KIND_COUNT) return;
+
+    for (uint32_t i = 0; i < TOUCH_LATENCY_TRIGGERS_MAX; i++) {
+        if (triggers[i].used) continue;
+        triggers[i].used = true;
+        triggers[i].affected = affected;
+        triggers[i].kind = kind;
+        lv_obj_add_event_cb(trigger, click_event_cb, LV_EVENT_CLICKED, &triggers[i]);
+        lv_obj_add_event_cb(trigger, trigger_delete_event_cb, LV_EVENT_DELETE, &triggers[i]);
+        return;
+    }
+    ESP_LOGW(TAG, "No free trigger slot for %s (TOUCH_LATENCY_TRIGGERS_MAX %d)",
+             touch_latency_kind_name(kind), TOUCH_LATENCY_TRIGGERS_MAX);
+}
+
+void touch_latency_note_sample(const touch_sample_t *sample) {
+    last_sample_us = sample->time_us;
+}
+
+// A flush in flight at click time never gets here again, so only flushes
+// rendered after the click can cover it
+void touch_latency_flush_start(const lv_area_t *area) {
+    int64_t now = esp_timer_get_time();
+    expire_pending(now);
+
+    for (uint8_t i = 0; i < pending_count; i++) {
+        pending_t &p = pending[i];
+        if (p.covered) continue;
+
+        lv_area_t common;
+        if (p.whole_screen || lv_area_intersect(&common, &p.area, area)) {
+            p.covered = true;
+            p.flush_start_us = now;
+        }
+    }
+}
+
+void touch_latency_flush_ready() {
+    touch_latency_flush_done(esp_timer_get_time());
+}
+
+void touch_latency_flush_done(int64_t done_us) {
+    for (uint8_t i = 0; i < pending_count;) {
+        if (!pending[i].covered) {
+            i++;
+            continue;
+        }
+        record(pending[i], done_us);
+        remove_pending(i);
+    }
+}
+
+const char* touch_latency_kind_name(touch_latency_kind_t kind) {
+    switch (kind) {
+        case TOUCH_LATENCY_TAB_CLICK:       return "tab_click";
+        case TOUCH_LATENCY_SETTINGS_BUTTON: return "settings_button";
+        case TOUCH_LATENCY_CARD_EXPAND:     return "card_expand";
+        case TOUCH_LATENCY_GALLERY_NEXT:    return "gallery_next";
+        default:                            return "unknown";
+    }
+}
+
+uint32_t touch_latency_bucket_limit_ms(uint8_t bucket) {
+    return bucket < TOUCH_LATENCY_BUCKETS - 1 ? bucket_limit_ms[bucket] : 0;
+}
+
+void touch_latency_get_stats(touch_latency_kind_t kind, touch_latency_stats_t *out) {
+    if (!out || kind >= TOUCH_LATENCY_KIND_COUNT) return;
+
+    const kind_acc_t &a = acc[kind];
+    *out = a.stats;
+    if (a.stats.count) {
+        out->total_avg_us = (uint32_t)(a.total_sum_us / a.stats.count);
+        out->dispatch_avg_us = (uint32_t)(a.dispatch_sum_us / a.stats.count);
+        out->render_avg_us = (uint32_t)(a.render_sum_us / a.stats.count);
+        out->flush_avg_us = (uint32_t)(a.flush_sum_us / a.stats.count);
+    }
+}
+
+void touch_latency_reset_stats() {
+    memset(acc, 0, sizeof(acc));
+}
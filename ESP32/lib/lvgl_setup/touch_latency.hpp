@@ -0,0 +1,94 @@
+#ifndef TOUCH_LATENCY_HPP
+#define TOUCH_LATENCY_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+#include "touch_sampler.hpp"
+
+/**
+ * Touch-to-photon latency per interaction
+ *
+ * A tracked button remembers when the touch sample that clicked it was
+ * taken, when LVGL dispatched the click, and then waits for the first flush
+ * that started after the click and overlaps the area the click changes.
+ * The measurement ends when that flush hands its buffer back
+ * (lv_display_flush_ready), i.e. when the new pixels are in panel memory.
+ * With DMA flushes that is when LVGL takes the buffer back: while it
+ * renders the frame's next chunk, or at the frame's REFR_READY for the
+ * last one, so a click is never charged the idle time after its frame.
+ * In the pipeline mode the flush task stamps when the job was done, and
+ * the LVGL task records that time when it takes the buffer back.
+ *
+ * Each interaction kind keeps a histogram of the total and the average of
+ * its three stages: dispatch (sample -> click handler), render (click ->
+ * first covering flush starts) and flush (transfer of that flush).
+ */
+
+// Clicks waiting for their flush at the same time
+#ifndef TOUCH_LATENCY_PENDING_MAX
+#define TOUCH_LATENCY_PENDING_MAX 4
+#endif
+
+// Buttons that can be tracked at the same time
+#ifndef TOUCH_LATENCY_TRIGGERS_MAX
+#define TOUCH_LATENCY_TRIGGERS_MAX 16
+#endif
+
+// A click with no covering flush after this long changed nothing visible
+#ifndef TOUCH_LATENCY_TIMEOUT_MS
+#define TOUCH_LATENCY_TIMEOUT_MS 1000
+#endif
+
+// Histogram buckets: < 16, 33, 50, 66, 100, 150, 250, 500 ms and the rest
+#define TOUCH_LATENCY_BUCKETS 9
+
+typedef enum {
+    TOUCH_LATENCY_TAB_CLICK,
+    TOUCH_LATENCY_SETTINGS_BUTTON,
+    TOUCH_LATENCY_CARD_EXPAND,
+    TOUCH_LATENCY_GALLERY_NEXT,
+    TOUCH_LATENCY_KIND_COUNT
+} touch_latency_kind_t;
+
+typedef struct {
+    uint32_t count;                          // Completed measurements
+    uint32_t timeouts;                       // Clicks that never reached a covering flush
+    uint32_t buckets[TOUCH_LATENCY_BUCKETS];
+    uint32_t total_avg_us;
+    uint32_t total_max_us;
+    uint32_t dispatch_avg_us;                // Sample taken -> click handler
+    uint32_t render_avg_us;                  // Click handler -> covering flush starts
+    uint32_t flush_avg_us;                   // Covering flush starts -> flush ready
+} touch_latency_stats_t;
+
+void touch_latency_init();
+
+/**
+ * Measure clicks on trigger (LVGL task)
+ *
+ * affected is the object whose area the click redraws, taken at click time;
+ * NULL means anywhere on the screen (for content created by the click).
+ * affected must live as long as trigger. The trigger keeps its other event
+ * handlers.
+ */
+void touch_latency_track(lv_obj_t *trigger, lv_obj_t *affected, touch_latency_kind_t kind);
+
+// The sample LVGL is about to process (touch read callback)
+void touch_latency_note_sample(const touch_sample_t *sample);
+
+// A flush of area is starting / its pixels are on the panel (flush path)
+void touch_latency_flush_start(const lv_area_t *area);
+void touch_latency_flush_ready();
+
+// Same, for pixels that reached the panel earlier, at done_us (esp_timer)
+void touch_latency_flush_done(int64_t done_us);
+
+const char* touch_latency_kind_name(touch_latency_kind_t kind);
+
+// Upper limit of a histogram bucket in ms (0 for the last, open-ended one)
+uint32_t touch_latency_bucket_limit_ms(uint8_t bucket);
+
+void touch_latency_get_stats(touch_latency_kind_t kind, touch_latency_stats_t *stats);
+void touch_latency_reset_stats();
+
+#endif // TOUCH_LATENCY_HPP
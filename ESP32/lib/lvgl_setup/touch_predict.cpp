@@ -0,0 +1,170 @@
+#include "touch_predict.hpp"
+#include <math.h>
+#include <string.h>
+
+// Predictions waiting for the sample that reaches their target time
+#define PREDICT_PENDING_MAX 8
+// Weight of the latest prediction in the confidence average
+#define PREDICT_CONFIDENCE_GAIN 0.25f
+
+typedef struct {
+    int64_t t_us;
+    float x;
+    float y;
+} point_t;
+
+typedef struct {
+    int64_t target_us;
+    point_t raw;               // Full extrapolation, judges the model
+    point_t applied;           // What LVGL got, judges the output
+    point_t base;              // The sample itself, judges doing nothing
+} pending_t;
+
+static bool enabled = TOUCH_PREDICT;
+
+// Per-press state
+static point_t hist[3];        // Oldest first
+static uint8_t hist_count = 0;
+static pending_t pending[PREDICT_PENDING_MAX];
+static uint8_t pending_count = 0;
+static float confidence = 0.0f;
+
+// Accumulated over presses
+static touch_predict_stats_t stats;
+static double err_sum = 0.0;
+static double lag_sum = 0.0;
+
+static float distance(const point_t &a, const point_t &b) {
+    return hypotf(a.x - b.x, a.y - b.y);
+}
+
+static float clamp_px(float v) {
+    if (v > TOUCH_PREDICT_MAX_PX) return TOUCH_PREDICT_MAX_PX;
+    if (v < -TOUCH_PREDICT_MAX_PX) return -TOUCH_PREDICT_MAX_PX;
+    return v;
+}
+
+// Score the predictions whose target time falls between prev and cur
+static void evaluate(const point_t &prev, const point_t &cur) {
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < pending_count; i++) {
+        const pending_t &p = pending[i];
+        if (p.target_us > cur.t_us) {
+            pending[kept++] = p;
+            continue;
+        }
+
+        // Where the finger really was at the target time
+        float f = 1.0f;
+        if (cur.t_us > prev.t_us && p.target_us > prev.t_us) {
+            f = (float)(p.target_us - prev.t_us) / (float)(cur.t_us - prev.t_us);
+        }
+        point_t actual = {p.target_us, prev.x + (cur.x - prev.x) * f, prev.y + (cur.y - prev.y) * f};
+
+        float err = distance(p.applied, actual);
+        float lag = distance(p.base, actual);
+        stats.evaluated++;
+        err_sum += err;
+        lag_sum += lag;
+        if (err > stats.err_max_px) stats.err_max_px = err;
+
+        // Trust the model as far as it beats standing still
+        float raw_err = distance(p.raw, actual);
+        float target = lag > 1.0f ? 1.0f - raw_err / lag : 0.0f;
+        if (target < 0.0f) target = 0.0f;
+        confidence += (target - confidence) * PREDICT_CONFIDENCE_GAIN;
+    }
+    pending_count = kept;
+}
+
+static void reset_press() {
+    hist_count = 0;
+    pending_count = 0;
+    confidence = 0.0f;
+}
+
+void touch_predict_set_enabled(bool on) {
+    enabled = on;
+    reset_press();
+}
+
+bool touch_predict_is_enabled() {
+    return enabled;
+}
+
+void touch_predict_apply(touch_sample_t *sample, bool scrolling) {
+    if (!sample->pressed) {
+        reset_press();
+        return;
+    }
+    stats.samples++;
+
+    point_t cur = {sample->time_us, (float)sample->x, (float)sample->y};
+    if (hist_count > 0) {
+        if (cur.t_us <= hist[hist_count - 1].t_us) return;  // Same sample read twice
+        evaluate(hist[hist_count - 1], cur);
+    }
+    if (hist_count == 3) {
+        hist[0] = hist[1];
+        hist[1] = hist[2];
+        hist_count = 2;
+    }
+    hist[hist_count++] = cur;
+
+    if (!enabled || !scrolling || hist_count < 2) return;
+
+    // Velocity from the last two samples, acceleration from the last three (px/ms, px/ms^2)
+    const point_t &p1 = hist[hist_count - 2];
+    float dt1 = (float)(cur.t_us - p1.t_us) / 1000.0f;
+    float vx = (cur.x - p1.x) / dt1;
+    float vy = (cur.y - p1.y) / dt1;
+    float ax = 0.0f;
+    float ay = 0.0f;
+    if (hist_count == 3) {
+        const point_t &p0 = hist[0];
+        float dt0 = (float)(p1.t_us - p0.t_us) / 1000.0f;
+        if (dt0 > 0.0f) {
+            ax = (vx - (p1.x - p0.x) / dt0) * 2.0f / (dt0 + dt1);
+            ay = (vy - (p1.y - p0.y) / dt0) * 2.0f / (dt0 + dt1);
+        }
+    }
+
+    if (hypotf(vx, vy) * 1000.0f < TOUCH_PREDICT_MIN_SPEED) {
+        stats.slow++;
+        return;
+    }
+
+    const float lead = TOUCH_PREDICT_LEAD_MS;
+    float ox = vx * lead + 0.5f * ax * lead * lead;
+    float oy = vy * lead + 0.5f * ay * lead * lead;
+    float dx = clamp_px(ox * confidence);
+    float dy = clamp_px(oy * confidence);
+
+    pending_t p;
+    p.target_us = cur.t_us + TOUCH_PREDICT_LEAD_MS * 1000;
+    p.raw = {p.target_us, cur.x + ox, cur.y + oy};
+    p.applied = {p.target_us, cur.x + dx, cur.y + dy};
+    p.base = cur;
+    if (pending_count == PREDICT_PENDING_MAX) {
+        memmove(&pending[0], &pending[1], sizeof(pending_t) * (PREDICT_PENDING_MAX - 1));
+        pending_count--;
+    }
+    pending[pending_count++] = p;
+
+    sample->x = (int16_t)lroundf(p.applied.x);
+    sample->y = (int16_t)lroundf(p.applied.y);
+    if (sample->x != (int16_t)cur.x || sample->y != (int16_t)cur.y) stats.predicted++;
+}
+
+void touch_predict_get_stats(touch_predict_stats_t *out) {
+    if (!out) return;
+    *out = stats;
+    out->err_avg_px = stats.evaluated ? (float)(err_sum / stats.evaluated) : 0.0f;
+    out->lag_avg_px = stats.evaluated ? (float)(lag_sum / stats.evaluated) : 0.0f;
+}
+
+void touch_predict_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+    err_sum = 0.0;
+    lag_sum = 0.0;
+}
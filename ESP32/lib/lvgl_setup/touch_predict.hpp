@@ -0,0 +1,65 @@
+#ifndef TOUCH_PREDICT_HPP
+#define TOUCH_PREDICT_HPP
+
+#include <stdint.h>
+#include "touch_sampler.hpp"
+
+/**
+ * Drag position prediction
+ *
+ * What is drawn during a scroll trails the finger by the sample age, one
+ * render and one flush. While LVGL is scrolling (tab content, pull-to-refresh
+ * container), the predictor moves each point to where the finger will be
+ * TOUCH_PREDICT_LEAD_MS after it was sampled, extrapolating from the
+ * velocity and acceleration of the last three samples.
+ *
+ * The offset is scaled by a confidence that tracks how well recent
+ * predictions matched the samples that followed, clamped to
+ * TOUCH_PREDICT_MAX_PX, and dropped below TOUCH_PREDICT_MIN_SPEED, where
+ * the lag is invisible and overshoot is not.
+ */
+
+#ifndef TOUCH_PREDICT
+#define TOUCH_PREDICT 1
+#endif
+
+// How far ahead of the sample to predict (sample age + render + flush)
+#ifndef TOUCH_PREDICT_LEAD_MS
+#define TOUCH_PREDICT_LEAD_MS 30
+#endif
+
+// Below this speed (px/s) points pass through unchanged
+#ifndef TOUCH_PREDICT_MIN_SPEED
+#define TOUCH_PREDICT_MIN_SPEED 150
+#endif
+
+// Largest offset applied to a point, per axis
+#ifndef TOUCH_PREDICT_MAX_PX
+#define TOUCH_PREDICT_MAX_PX 24
+#endif
+
+typedef struct {
+    uint32_t samples;          // Pressed samples seen
+    uint32_t predicted;        // Points moved by the predictor
+    uint32_t slow;             // Points left alone below TOUCH_PREDICT_MIN_SPEED
+    uint32_t evaluated;        // Predictions compared with the real position at their target time
+    float err_avg_px;          // Predicted vs real position
+    float err_max_px;
+    float lag_avg_px;          // Unpredicted point vs real position (what prediction tries to remove)
+} touch_predict_stats_t;
+
+void touch_predict_set_enabled(bool enabled);
+bool touch_predict_is_enabled();
+
+/**
+ * Feed one filtered sample and predict it in place (LVGL task)
+ *
+ * Every sample must pass through to keep the history; only pressed samples
+ * while scrolling is true are moved. A release resets the history.
+ */
+void touch_predict_apply(touch_sample_t *sample, bool scrolling);
+
+void touch_predict_get_stats(touch_predict_stats_t *stats);
+void touch_predict_reset_stats();
+
+#endif // TOUCH_PREDICT_HPP
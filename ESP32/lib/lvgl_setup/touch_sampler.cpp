@@ -0,0 +1,183 @@
+#include "touch_sampler.hpp"
+#include "spsc_ring.hpp"
+#include "bus_arbiter.hpp"
+#include "lvgl_setup.hpp"
+#include "lvgl_task.hpp"
+#include "display.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <string.h>
+
+#ifndef NATIVE_BUILD
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <driver/gpio.h>
+#endif
+
+static const char* TAG = "TOUCH";
+
+// Longest the sampler waits for the display to yield the bus before skipping a period
+#ifndef TOUCH_BUS_TIMEOUT_MS
+#define TOUCH_BUS_TIMEOUT_MS 50
+#endif
+
+static spsc_ring<touch_sample_t, TOUCH_RING_SIZE> ring;
+static touch_sampler_stats_t stats;
+
+// Producer state
+static bool pen_pressed = false;
+static int16_t last_x = 0;
+static int16_t last_y = 0;
+
+/**
+ * Read the controller once and queue the result
+ *
+ * Returns true while the pen is still down. A release is queued once, with
+ * the last pressed position, so LVGL sees where the finger left.
+ */
+static bool sample() {
+    if (!bus_arbiter_acquire(BUS_CLIENT_TOUCH, TOUCH_BUS_TIMEOUT_MS)) {
+        stats.bus_timeouts++;
+        return pen_pressed;
+    }
+    uint16_t x, y;
+    bool touched = gfx.getTouch(&x, &y);
+    bus_arbiter_release(BUS_CLIENT_TOUCH);
+    stats.reads++;
+
+    // PENIRQ also fires on pressure too light for a valid reading
+    if (!touched && !pen_pressed) return false;
+
+    if (touched) {
+        last_x = (int16_t)x;
+        last_y = (int16_t)y;
+    }
+    pen_pressed = touched;
+
+    touch_sample_t s;
+    s.time_us = esp_timer_get_time();
+    s.x = last_x;
+    s.y = last_y;
+    s.pressed = touched;
+    if (ring.push(s)) {
+        stats.samples++;
+#if TOUCH_SAMPLER_TASK
+        lvgl_task_wake(LVGL_TASK_WAKE_TOUCH);
+#endif
+    } else {
+        stats.dropped++;
+    }
+    return touched;
+}
+
+#if TOUCH_SAMPLER_TASK
+static TaskHandle_t sampler_task = NULL;
+
+static void IRAM_ATTR pen_down_isr(void *arg) {
+    (void)arg;
+    // Level-triggered: stays masked until the task has sampled through the release
+    gpio_intr_disable((gpio_num_t)TFT_TOUCH_PIN_INT);
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(sampler_task, &woken);
+    if (woken) portYIELD_FROM_ISR();
+}
+
+static void sampler_task_fn(void *arg) {
+    (void)arg;
+    for (;;) {
+        // Sleep until PENIRQ goes low; no SPI traffic at all while idle
+        gpio_intr_enable((gpio_num_t)TFT_TOUCH_PIN_INT);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        stats.wakeups++;
+
+        TickType_t wake = xTaskGetTickCount();
+        while (sample()) {
+            vTaskDelayUntil(&wake, pdMS_TO_TICKS(TOUCH_SAMPLE_PERIOD_MS));
+        }
+    }
+}
+#else
+static int64_t last_sample_us = 0;
+
+// PENIRQ level (the scripted touch state in the native build)
+static bool pen_down() {
+#ifdef NATIVE_BUILD
+    return gfx.getHostPenDown();
+#else
+    return gpio_get_level((gpio_num_t)TFT_TOUCH_PIN_INT) == 0;
+#endif
+}
+#endif
+
+bool touch_sampler_init() {
+    memset(&stats, 0, sizeof(stats));
+
+#if TOUCH_SAMPLER_TASK
+    gpio_config_t io = {};
+    io.pin_bit_mask = 1ULL << TFT_TOUCH_PIN_INT;
+    io.mode = GPIO_MODE_INPUT;
+    io.pull_up_en = GPIO_PULLUP_ENABLE;  // PENIRQ only pulls low
+    io.intr_type = GPIO_INTR_LOW_LEVEL;
+    gpio_config(&io);
+    gpio_intr_disable((gpio_num_t)TFT_TOUCH_PIN_INT);  // The task arms it
+
+    // Handler first: the task arms the interrupt as soon as it runs.
+    // Arduino may have installed the shared ISR service already
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "GPIO ISR service failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    err = gpio_isr_handler_add((gpio_num_t)TFT_TOUCH_PIN_INT, pen_down_isr, NULL);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Pen-down interrupt on GPIO %d failed: %s", TFT_TOUCH_PIN_INT, esp_err_to_name(err));
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(sampler_task_fn, "touch", 3072, NULL,
+                                TOUCH_TASK_PRIORITY, &sampler_task, TOUCH_TASK_CORE) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create touch sampling task");
+        gpio_isr_handler_remove((gpio_num_t)TFT_TOUCH_PIN_INT);
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Touch sampling task on core %d, pen-down interrupt on GPIO %d, %d ms period",
+             TOUCH_TASK_CORE, TFT_TOUCH_PIN_INT, TOUCH_SAMPLE_PERIOD_MS);
+#else
+    ESP_LOGI(TAG, "Touch sampled from the read callback while the pen is down, %d ms period",
+             TOUCH_SAMPLE_PERIOD_MS);
+#endif
+    return true;
+}
+
+bool touch_sampler_pop(touch_sample_t *sample) {
+    return ring.pop(sample);
+}
+
+bool touch_sampler_pending() {
+    return !ring.empty();
+}
+
+void touch_sampler_poll() {
+#if !TOUCH_SAMPLER_TASK
+    if (!pen_pressed && !pen_down()) return;
+
+    int64_t now = esp_timer_get_time();
+    if (pen_pressed && now - last_sample_us < TOUCH_SAMPLE_PERIOD_MS * 1000) return;
+    if (!pen_pressed) stats.wakeups++;
+    last_sample_us = now;
+
+    // Same task as the flush: finish the transfer in flight before reading
+    lvgl_flush_wait_idle();
+    sample();
+#endif
+}
+
+void touch_sampler_get_stats(touch_sampler_stats_t *out) {
+    if (out) *out = stats;
+}
+
+void touch_sampler_reset_stats() {
+    memset(&stats, 0, sizeof(stats));
+}
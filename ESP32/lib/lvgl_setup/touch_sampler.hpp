@@ -0,0 +1,84 @@
+#ifndef TOUCH_SAMPLER_HPP
+#define TOUCH_SAMPLER_HPP
+
+#include <stdint.h>
+
+/**
+ * Interrupt-gated XPT2046 sampling
+ *
+ * The XPT2046 pulls PENIRQ (TFT_TOUCH_PIN_INT) low while the panel is
+ * pressed. A FreeRTOS task sleeps on that interrupt, samples the controller
+ * every TOUCH_SAMPLE_PERIOD_MS while the pen stays down, pushes
+ * timestamped points into a lock-free ring and wakes the LVGL task
+ * (lvgl_task.hpp) to read them. The LVGL read callback only drains the
+ * ring, so an untouched screen costs no touch SPI traffic and the indev
+ * never waits on the bus. The task takes the bus through bus_arbiter, so a
+ * read waits at most for the frame being flushed, usually one chunk.
+ *
+ * Without the task (TOUCH_SAMPLER_TASK=0, always in the native build) the
+ * read callback calls touch_sampler_poll(), which applies the same pen-down
+ * gate and period inline.
+ */
+
+#ifndef TOUCH_SAMPLER_TASK
+#ifdef NATIVE_BUILD
+#define TOUCH_SAMPLER_TASK 0
+#else
+#define TOUCH_SAMPLER_TASK 1
+#endif
+#endif
+
+// Sampling period while pressed (LVGL reads the indev every 30 ms by default)
+#ifndef TOUCH_SAMPLE_PERIOD_MS
+#define TOUCH_SAMPLE_PERIOD_MS 10
+#endif
+
+// Ring entries (power of two); one LVGL read period of samples fits many times over
+#ifndef TOUCH_RING_SIZE
+#define TOUCH_RING_SIZE 32
+#endif
+
+// Above the Arduino loop task (1), so a sample is never late behind a render
+#ifndef TOUCH_TASK_PRIORITY
+#define TOUCH_TASK_PRIORITY 3
+#endif
+#ifndef TOUCH_TASK_CORE
+#define TOUCH_TASK_CORE 0
+#endif
+
+typedef struct {
+    int64_t time_us;           // esp_timer_get_time() when the sample was taken
+    int16_t x;
+    int16_t y;                 // Last pressed position on release samples
+    bool pressed;
+} touch_sample_t;
+
+typedef struct {
+    uint32_t wakeups;          // Pen-down interrupts (or pen-down edges when polled)
+    uint32_t reads;            // gfx.getTouch() calls, i.e. touch SPI transactions
+    uint32_t samples;          // Samples pushed into the ring
+    uint32_t dropped;          // Samples lost to a full ring
+    uint32_t bus_timeouts;     // Samples skipped because the display held the bus too long
+} touch_sampler_stats_t;
+
+/**
+ * Arm the pen-down interrupt and start the sampling task
+ *
+ * Call after init_touch() and init_lvgl_display(). Returns false when the
+ * interrupt or the task could not be set up.
+ */
+bool touch_sampler_init();
+
+// Consumer side (LVGL task): oldest unread sample, false when there is none
+bool touch_sampler_pop(touch_sample_t *sample);
+
+// Consumer side: more samples are waiting
+bool touch_sampler_pending();
+
+// Sample inline when the pen is down and a period has passed (TOUCH_SAMPLER_TASK=0)
+void touch_sampler_poll();
+
+void touch_sampler_get_stats(touch_sampler_stats_t *stats);
+void touch_sampler_reset_stats();
+
+#endif // TOUCH_SAMPLER_HPP
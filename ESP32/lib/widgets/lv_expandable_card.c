@@ -551,6 +551,16 @@ bool lv_expandable_card_is_expanded(lv_obj_t* card) {
     return data->expanded;
 }
 
+/**
+ * Get the expand/collapse button
+ */
+lv_obj_t* lv_expandable_card_get_expand_button(lv_obj_t* card) {
+    lv_card_widget_data_t* data = get_card_data(card);
+    if (!data) return NULL;
+
+    return data->expand_btn;
+}
+
 /**
  * Toggle the expansion state
  */
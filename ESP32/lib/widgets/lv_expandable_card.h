@@ -159,6 +159,17 @@ bool lv_expandable_card_set_expanded(lv_obj_t* card, bool expanded);
  */
 bool lv_expandable_card_is_expanded(lv_obj_t* card);
 
+/**
+ * @brief Get the expand/collapse button
+ *
+ * For attaching extra event handlers (the card keeps its own click handler).
+ *
+ * @param card Card object returned by lv_expandable_card_create()
+ *
+ * @return Button object, or NULL on error
+ */
+lv_obj_t* lv_expandable_card_get_expand_button(lv_obj_t* card);
+
 /**
  * @brief Toggle the expansion state
  *
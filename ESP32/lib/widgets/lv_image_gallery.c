@@ -29,6 +29,8 @@ typedef struct {
     int                       current_index; /**< Current displayed image index */
     lv_obj_t*                 img_obj;       /**< Image display object */
     lv_obj_t*                 counter_label; /**< Counter label object */
+    lv_obj_t*                 prev_btn;      /**< Previous image button */
+    lv_obj_t*                 next_btn;      /**< Next image button */
     lv_gallery_config_t       config;        /**< Widget configuration */
     char*                     counter_format; /**< Cached counter text format */
 } lv_gallery_data_t;
@@ -269,6 +271,8 @@ lv_obj_t* lv_image_gallery_create(
     data->current_index = 0;
     data->img_obj = NULL;
     data->counter_label = NULL;
+    data->prev_btn = NULL;
+    data->next_btn = NULL;
     data->config = cfg;
     data->counter_format = NULL;
     
@@ -368,6 +372,8 @@ lv_obj_t* lv_image_gallery_create(
         cleanup_gallery_data(data);
         return NULL;
     }
+    data->prev_btn = prev_btn;
+    data->next_btn = next_btn;
     
     // Initialize display with first image
     update_gallery_display(data);
@@ -404,6 +410,23 @@ int lv_image_gallery_get_index(lv_obj_t* gallery) {
     return data->current_index;
 }
 
+/**
+ * Get the navigation buttons
+ */
+lv_obj_t* lv_image_gallery_get_next_button(lv_obj_t* gallery) {
+    lv_gallery_data_t* data = get_gallery_data(gallery);
+    if (!data) return NULL;
+
+    return data->next_btn;
+}
+
+lv_obj_t* lv_image_gallery_get_prev_button(lv_obj_t* gallery) {
+    lv_gallery_data_t* data = get_gallery_data(gallery);
+    if (!data) return NULL;
+
+    return data->prev_btn;
+}
+
 /**
  * Navigate to next image
  */
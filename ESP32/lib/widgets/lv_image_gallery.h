@@ -149,6 +149,26 @@ bool lv_image_gallery_set_index(lv_obj_t* gallery, int index);
  */
 int lv_image_gallery_get_index(lv_obj_t* gallery);
 
+/**
+ * @brief Get the "next" navigation button
+ * 
+ * For attaching extra event handlers (the gallery keeps its own click handler).
+ * 
+ * @param gallery Gallery object returned by lv_image_gallery_create()
+ * 
+ * @return Button object, or NULL on error
+ */
+lv_obj_t* lv_image_gallery_get_next_button(lv_obj_t* gallery);
+
+/**
+ * @brief Get the "previous" navigation button
+ * 
+ * @param gallery Gallery object returned by lv_image_gallery_create()
+ * 
+ * @return Button object, or NULL on error
+ */
+lv_obj_t* lv_image_gallery_get_prev_button(lv_obj_t* gallery);
+
 /**
  * @brief Navigate to the next image
  * 
@@ -5,6 +5,8 @@
 #include "settings_modal.h"
 #include "ui_helpers.h"
 #include "theme_manager.h"
+#include "touch_latency.hpp"
+#include "touch_gesture.hpp"
 
 static const char* TAG = "TABVIEW";
 
@@ -28,6 +30,28 @@ static void settings_btn_event_cb(lv_event_t *e) {
     ESP_LOGI(TAG, "Settings modal opened");
 }
 
+// Horizontal swipe on the content moves to the neighbouring tab. The content
+// itself does not scroll sideways, so nothing is redrawn while the finger moves.
+static void tab_content_swipe_cb(lv_obj_t *obj, const touch_gesture_t *gesture, void *user_data) {
+    (void)obj;
+    lv_obj_t *tabview = (lv_obj_t *)user_data;
+    if (gesture->dir != TOUCH_GESTURE_DIR_LEFT && gesture->dir != TOUCH_GESTURE_DIR_RIGHT) return;
+
+    // Tabs run right to left in RTL, so the next tab is revealed by a swipe to the right
+    bool rtl = lv_obj_get_style_base_dir(tabview, LV_PART_MAIN) == LV_BASE_DIR_RTL;
+    bool forward = (gesture->dir == TOUCH_GESTURE_DIR_LEFT) != rtl;
+    uint32_t active = lv_tabview_get_tab_active(tabview);
+    uint32_t count = lv_tabview_get_tab_count(tabview);
+    if (forward && active + 1 < count) {
+        lv_tabview_set_active(tabview, active + 1, LV_ANIM_OFF);
+    } else if (!forward && active > 0) {
+        lv_tabview_set_active(tabview, active - 1, LV_ANIM_OFF);
+    } else {
+        return;
+    }
+    ESP_LOGI(TAG, "%s to tab %u", touch_gesture_type_name(gesture->type), (unsigned)lv_tabview_get_tab_active(tabview));
+}
+
 lv_obj_t* create_hebrew_tabview(lv_obj_t *parent) {
     ESP_LOGW(TAG, "FUNCTION CALLED: create_hebrew_tabview");
     ESP_LOGI(TAG, "Creating Hebrew tabview...");
@@ -82,8 +106,10 @@ lv_obj_t* create_hebrew_tabview(lv_obj_t *parent) {
     lv_obj_set_flex_align(tab_buttons, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
 
     uint32_t tab_count = lv_tabview_get_tab_count(tabview);
+    lv_obj_t *tab_pages = lv_tabview_get_content(tabview);
     for(uint32_t i = 0; i < tab_count; i++) {
         lv_obj_t * button = lv_obj_get_child(tab_buttons, i);
+        touch_latency_track(button, tab_pages, TOUCH_LATENCY_TAB_CLICK);
 
         // Apply styling directly (more efficient than static style objects)
         lv_obj_set_style_text_font(button, &opensans_hebrew_16, LV_PART_MAIN);
@@ -114,6 +140,8 @@ lv_obj_t* create_hebrew_tabview(lv_obj_t *parent) {
 
     // Add event callback
     lv_obj_add_event_cb(settings_btn, settings_btn_event_cb, LV_EVENT_CLICKED, NULL);
+    // The modal is created by the click, anywhere on the screen counts
+    touch_latency_track(settings_btn, NULL, TOUCH_LATENCY_SETTINGS_BUTTON);
 
     // Disable horizontal swiping on tab content (keep only tab bar swipeable)
     lv_obj_t* tab_content = lv_tabview_get_content(tabview);
@@ -121,6 +149,9 @@ lv_obj_t* create_hebrew_tabview(lv_obj_t *parent) {
         // Disable horizontal scrolling on content area only
         lv_obj_set_scroll_dir(tab_content, LV_DIR_VER);
         ESP_LOGI(TAG, "Disabled horizontal swiping on tab content");
+
+        // Switch tabs on a horizontal swipe instead
+        touch_gesture_subscribe(tab_content, TOUCH_GESTURE_MASK_SWIPES, tab_content_swipe_cb, tabview);
     }
 
     // Also disable horizontal scrolling on each individual tab
@@ -5,7 +5,17 @@
 #include "hebrew_tabs.h"
 #include "display.hpp"
 #include "lvgl_setup.hpp"
+#include "lvgl_task.hpp"
+#include "power_manager.hpp"
+#include "refresh_governor.hpp"
+#include "ui_command.h"
+#include "perf_metrics.hpp"
+#include "pixel_convert.hpp"
+#include "input_record.hpp"
 #include "hebrew_fonts.h"
+#if INPUT_RECORD_MODE != INPUT_RECORD_OFF
+#include <SPIFFS.h>
+#endif
 
 static const char* TAG = "MAIN";
 
@@ -29,6 +39,9 @@ void create_fps_label() {
     // Make sure it stays on top
     lv_obj_move_to_index(fps_label, -1);
 
+    // Its once-a-second update alone does not keep the refresh rate up
+    refresh_governor_add_ambient(fps_label);
+
     ESP_LOGI(TAG, "FPS label created");
 }
 
@@ -54,17 +67,37 @@ void setup() {
 
     init_display();
     init_touch();
+    lvgl_task_init();  // loop() runs LVGL
     init_lvgl_display();
     init_lvgl_input_device();
-    init_lvgl_timer();
+    power_manager_init();
+    perf_metrics_add_report(ui_command_report_stats);
+
+#if PIXEL_PIPELINE_BENCHMARK > 0
+    pixel_pipeline_bench_t bench[3];
+    pixel_convert_benchmark(PIXEL_PIPELINE_BENCHMARK, bench, 3);
+#endif
+
     create_ui();
 
+#if INPUT_RECORD_MODE != INPUT_RECORD_OFF
+    // Recordings live on the SPIFFS partition, mounted at /spiffs
+    if (!SPIFFS.begin(INPUT_RECORD_MODE == INPUT_RECORD_CAPTURE)) {
+        ESP_LOGE(TAG, "SPIFFS mount failed, input record/replay disabled");
+    } else if (INPUT_RECORD_MODE == INPUT_RECORD_CAPTURE) {
+        input_record_start();
+    } else {
+        input_replay_start(indev, INPUT_RECORD_PATH);
+    }
+#endif
+
     ESP_LOGI(TAG, "Setup complete");
 }
 
 unsigned long last_frame_time = 0;
-int frame_count = 0;
 float current_FPS = 0.0;
+// Frame counters at the last FPS label update
+static perf_frame_counters_t fps_frames;
 
 
 // Function to toggle FPS display (can be called from settings)
@@ -78,20 +111,9 @@ bool is_fps_display_enabled() {
     return fps_display_enabled;
 }
 
-// Performance tracking
-unsigned long max_render_time = 0;
-unsigned long total_render_time = 0;
-int render_samples = 0;
+// Performance tracking (histograms in perf_metrics.hpp)
 unsigned long last_benchmark_reset = 0;
 
-// Responsivity tracking
-int frames_under_100ms = 0;    // Good performance
-int frames_under_450ms = 0;    // Acceptable performance
-int frames_under_550ms = 0;    // Poor but usable
-int frames_above_550ms = 0;    // Severe lag
-unsigned long lastTouchTime = 0;
-bool touchActive = false;
-
 void loop() {
 
   unsigned long current_time = millis();
@@ -99,10 +121,18 @@ void loop() {
 
   // Only update FPS every second or so to avoid flickering and excessive calculations
   if (elapsedTime >= 1000) {
-    current_FPS = (float)frame_count / (elapsedTime / 1000.0);
-    frame_count = 0;
+    // Frames that reached the panel, not loop() passes
+    perf_frame_counters_t frames;
+    perf_frame_rates_t rates;
+    perf_metrics_get_frame_counters(&frames);
+    perf_metrics_frame_rates(&fps_frames, &frames, &rates);
+    current_FPS = rates.fps;
+    fps_frames = frames;
     last_frame_time = current_time;
 
+    // LVGL calls outside lv_timer_handler() hold the LVGL lock (LV_USE_OS)
+    lv_lock();
+
     // Get LVGL memory info for display
     lv_mem_monitor_t mem_display;
     lv_mem_monitor(&mem_display);
@@ -121,26 +151,39 @@ void loop() {
         lv_obj_add_flag(fps_label, LV_OBJ_FLAG_HIDDEN);
       }
     }
+    lv_unlock();
   }
 
-  unsigned long render_start = micros();
-  // LVGL handler
-  lv_timer_handler();
-  unsigned long render_end = micros();
-
-  // Track render performance
-  unsigned long render_time = render_end - render_start;
-  total_render_time += render_time;
-  render_samples++;
-  if (render_time > max_render_time) {
-    max_render_time = render_time;
+#if INPUT_RECORD_MODE == INPUT_RECORD_CAPTURE
+  // Save the session once it is long enough
+  if (input_record_is_active() && millis() >= INPUT_RECORD_SECONDS * 1000UL) {
+    input_record_stop(INPUT_RECORD_PATH);
   }
-
-  // Track frame performance buckets
-  if (render_time < 100000) frames_under_100ms++;        // <100ms (good)
-  else if (render_time < 450000) frames_under_450ms++;   // 100-450ms (acceptable)
-  else if (render_time < 550000) frames_under_550ms++;   // 450-550ms (poor)
-  else frames_above_550ms++;                             // >550ms (severe lag)
+#elif INPUT_RECORD_MODE == INPUT_RECORD_REPLAY
+  static bool replay_reported = false;
+  if (!replay_reported && !input_replay_is_active()) {
+    input_record_stats_t rec;
+    input_record_get_stats(&rec);
+    ESP_LOGI(TAG, "REPLAY - %lu events over %lu ms, late by %lu ms avg (max %lu)",
+             (unsigned long)rec.replayed, (unsigned long)rec.replay_ms,
+             (unsigned long)rec.late_avg_ms, (unsigned long)rec.late_max_ms);
+    replay_reported = true;
+  }
+#endif
+
+  // Changes posted by other tasks go into this frame
+  ui_command_drain();
+
+  int64_t render_start = perf_metrics_now_us();
+  // LVGL handler; returns when its next timer is due
+  uint32_t next_timer_ms = lv_timer_handler();
+  uint32_t render_time = (uint32_t)(perf_metrics_now_us() - render_start);
+  perf_metrics_record(PERF_TIMER_HANDLER, render_time);
+  // CPU speed, backlight, panel and refresh period follow what LVGL just did
+  lv_lock();
+  power_manager_update();
+  refresh_governor_update();
+  lv_unlock();
 
   // Log memory usage and performance stats
   if (elapsedTime >= 100) {
@@ -151,41 +194,29 @@ void loop() {
 
     // LVGL memory info
     lv_mem_monitor_t mem_mon;
+    lv_lock();
     lv_mem_monitor(&mem_mon);
+    lv_unlock();
 
-    // Calculate average render time
-    unsigned long avgRenderTime = render_samples > 0 ? total_render_time / render_samples : 0;
+    // Timer handler so far in this 10 s window
+    static perf_metric_snapshot_t perf;
+    perf_metrics_snapshot(PERF_TIMER_HANDLER, &perf);
 
     ESP_LOGI(TAG, "Memory - ESP32: %lu/%lu KB (%.1f%%), LVGL: %zu/%zu KB (%d%%, frag: %d%%), Render: %lu us (avg: %lu, max: %lu)",
              used_heap / 1024, total_heap / 1024, (float)used_heap * 100.0 / total_heap,
              (mem_mon.total_size - mem_mon.free_size) / 1024, mem_mon.total_size / 1024,
              mem_mon.used_pct, mem_mon.frag_pct,
-             render_time, avgRenderTime, max_render_time);
+             (unsigned long)render_time, (unsigned long)perf.summary.avg_us, (unsigned long)perf.summary.max_us);
 
     // Reset benchmark every 10 seconds
     if (current_time - last_benchmark_reset >= 10000) {
-      // Calculate responsivity percentages
-      float good = render_samples > 0 ? (float)frames_under_100ms * 100.0 / render_samples : 0;
-      float acceptable = render_samples > 0 ? (float)frames_under_450ms * 100.0 / render_samples : 0;
-      float poor = render_samples > 0 ? (float)frames_under_550ms * 100.0 / render_samples : 0;
-      float severe = render_samples > 0 ? (float)frames_above_550ms * 100.0 / render_samples : 0;
-
-      ESP_LOGI(TAG, "RESPONSIVITY - Good(<100ms): %.1f%% OK(100-450ms): %.1f%% Poor(450-550ms): %.1f%% Severe(>550ms): %.1f%% (Samples: %d)",
-               good, acceptable, poor, severe, render_samples);
-
-      max_render_time = 0;
-      total_render_time = 0;
-      render_samples = 0;
-      frames_under_100ms = 0;
-      frames_under_450ms = 0;
-      frames_under_550ms = 0;
-      frames_above_550ms = 0;
+      // Every module logs and resets its own stats (perf_metrics_add_report())
+      perf_metrics_report();
       last_benchmark_reset = current_time;
     }
   }
 
-  vTaskDelay(pdMS_TO_TICKS(TASK_SLEEP_PERIOD_MS));
-  
-  frame_count++;
+  // Sleep until the next LVGL timer, or until touch or another task wakes us
+  lvgl_task_wait(next_timer_ms);
 }
 
@@ -0,0 +1,504 @@
+/**
+ * @file bench_main.cpp
+ * @brief Headless frame-time benchmark for the host-native build
+ *
+ * Builds the complete Hebrew UI against the in-memory LGFX stand-in, drives
+ * lv_timer_handler() on a simulated clock exactly like loop() does on the
+ * device, replays a scripted session and prints per-frame statistics as JSON
+ * on stdout. Logs go to stderr.
+ *
+ * --bus-mhz simulates SPI wire time in the LGFX stand-in, so frame_us shows
+ * how much of the transfer is hidden behind rendering (LVGL_FLUSH_MODE).
+ *
+ * --bench-pixels N skips the UI session and instead pushes N full-screen
+ * frames through each pixel pipeline of this build (pixel_convert.hpp).
+ *
+ * --rotation R switches the panel orientation at runtime after the UI is
+ * built (lvgl_set_rotation), as a device deployment in landscape would.
+ *
+ * --bench-touch-filter replays jitter traces through each touch filter
+ * configuration instead of the session (bench_touch_filter.hpp); --trace
+ * adds a trace recorded on the device.
+ *
+ * --replay FILE drives the UI with a touch recording (input_record.hpp)
+ * instead of the scripted session; --record FILE saves the touch input of
+ * the run in the same format.
+ *
+ * Usage: program [--duration-ms N] [--bus-mhz N] [--bench-pixels N] [--rotation R]
+ *                [--bench-touch-filter [--trace FILE]] [--replay FILE] [--record FILE]
+ *                [--summary-only] [--verbose]
+ */
+
+#include <lvgl.h>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "display.hpp"
+#include "lvgl_setup.hpp"
+#include "lvgl_task.hpp"
+#include "power_manager.hpp"
+#include "refresh_governor.hpp"
+#include "ui_command.h"
+#include "perf_metrics.hpp"
+#include "flush_scheduler.hpp"
+#include "flush_pipeline.hpp"
+#include "flush_encoder.hpp"
+#include "shadow_fb.hpp"
+#include "pixel_convert.hpp"
+#include "draw_buffers.hpp"
+#include "touch_sampler.hpp"
+#include "touch_predict.hpp"
+#include "touch_latency.hpp"
+#include "input_record.hpp"
+#include "touch_gesture.hpp"
+#include "bus_arbiter.hpp"
+#include "hebrew_tabs.h"
+#include "bench_scenario.hpp"
+#include "bench_touch_filter.hpp"
+
+static const char* TAG = "BENCH";
+
+// Simulated time after the last replayed event, for the UI to settle
+#define REPLAY_SETTLE_MS 1000
+
+typedef struct {
+    uint32_t t_ms;
+    uint32_t render_us;      // lv_timer_handler() duration
+    uint32_t frame_us;       // Until the last byte of the frame left the bus
+    uint64_t pixel_bytes;
+    uint64_t command_bytes;
+    uint32_t windows;
+    uint32_t areas;          // Invalidated areas before the scheduler merged them
+    uint32_t merged;
+    uint32_t transactions;
+    uint32_t heap_used;
+    const char* step;
+} bench_frame_t;
+
+typedef struct {
+    uint32_t duration_ms;
+    uint32_t bus_mhz;
+    uint32_t bench_pixels;
+    int rotation;            // -1 = keep TFT_ROTATION
+    bool bench_touch_filter;
+    const char* trace_path;  // Extra recorded trace for --bench-touch-filter
+    const char* replay_path; // Touch recording to play instead of the script
+    const char* record_path; // Where to save the run's touch input
+    bool summary_only;
+} bench_options_t;
+
+// The settings modal links against these from main.cpp on the device
+static bool fps_display_enabled = true;
+
+void toggle_fps_display() {
+    fps_display_enabled = !fps_display_enabled;
+}
+
+bool is_fps_display_enabled() {
+    return fps_display_enabled;
+}
+
+static bool parse_options(int argc, char** argv, bench_options_t* opts) {
+    opts->duration_ms = 0;  // 0 = one scenario pass
+    opts->bus_mhz = 0;      // 0 = transfers are instant
+    opts->bench_pixels = 0;
+    opts->rotation = -1;
+    opts->bench_touch_filter = false;
+    opts->trace_path = NULL;
+    opts->replay_path = NULL;
+    opts->record_path = NULL;
+    opts->summary_only = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--duration-ms") == 0 && i + 1 < argc) {
+            opts->duration_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--bus-mhz") == 0 && i + 1 < argc) {
+            opts->bus_mhz = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--rotation") == 0 && i + 1 < argc) {
+            opts->rotation = atoi(argv[++i]) & 3;
+        } else if (strcmp(argv[i], "--bench-pixels") == 0 && i + 1 < argc) {
+            opts->bench_pixels = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--bench-touch-filter") == 0) {
+            opts->bench_touch_filter = true;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            opts->trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            opts->replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            opts->record_path = argv[++i];
+        } else if (strcmp(argv[i], "--summary-only") == 0) {
+            opts->summary_only = true;
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            esp_log_level_set("*", ESP_LOG_INFO);
+        } else {
+            fprintf(stderr, "Usage: %s [--duration-ms N] [--bus-mhz N] [--bench-pixels N] [--rotation R] "
+                    "[--bench-touch-filter [--trace FILE]] [--replay FILE] [--record FILE] "
+                    "[--summary-only] [--verbose]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static const char* flush_mode_name() {
+    switch (LVGL_FLUSH_MODE) {
+        case LVGL_FLUSH_BLOCKING: return "blocking";
+        case LVGL_FLUSH_PIPELINE: return "pipeline";
+        default: return "async";
+    }
+}
+
+static const char* render_mode_name(lv_display_render_mode_t mode) {
+    switch (mode) {
+        case LV_DISPLAY_RENDER_MODE_DIRECT: return "direct";
+        case LV_DISPLAY_RENDER_MODE_FULL: return "full";
+        default: return "partial";
+    }
+}
+
+static int run_pixel_benchmark(const bench_options_t* opts) {
+    pixel_pipeline_bench_t results[3];
+    int count = pixel_convert_benchmark(opts->bench_pixels, results, 3);
+
+    printf("{\n");
+    printf("  \"env\": \"native\",\n");
+    printf("  \"resolution\": [%d, %d],\n", (int)gfx.width(), (int)gfx.height());
+    printf("  \"color_depth\": %d,\n", LV_COLOR_DEPTH);
+    printf("  \"bus_mhz\": %u,\n", opts->bus_mhz);
+    printf("  \"frames\": %u,\n", opts->bench_pixels);
+    printf("  \"pipelines\": [\n");
+    for (int i = 0; i < count; i++) {
+        printf("    {\"pipeline\": \"%s\", \"frame_us\": %u, \"bytes_per_s\": %u}%s\n",
+               pixel_convert_pipeline_name(results[i].pipeline), results[i].frame_us,
+               results[i].bytes_per_s, i + 1 < count ? "," : "");
+    }
+    printf("  ]\n");
+    printf("}\n");
+    return count > 0 ? 0 : 1;
+}
+
+static uint32_t percentile(std::vector<uint32_t> values, uint32_t pct) {
+    if (values.empty()) return 0;
+    std::sort(values.begin(), values.end());
+    size_t idx = (values.size() - 1) * pct / 100;
+    return values[idx];
+}
+
+static uint32_t lvgl_heap_used(uint32_t* total) {
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    if (total) *total = (uint32_t)mon.total_size;
+    return (uint32_t)(mon.total_size - mon.free_size);
+}
+
+static void print_report(const bench_options_t* opts, uint32_t iterations,
+                         const std::vector<bench_frame_t>& frames) {
+    std::vector<uint32_t> render_times;
+    std::vector<uint32_t> frame_times;
+    uint64_t pixel_bytes = 0;
+    uint64_t command_bytes = 0;
+    uint32_t windows = 0;
+    uint32_t areas = 0;
+    uint32_t merged = 0;
+    uint32_t transactions = 0;
+    uint32_t heap_peak = 0;
+    uint64_t render_total = 0;
+
+    for (const bench_frame_t& f : frames) {
+        render_times.push_back(f.render_us);
+        frame_times.push_back(f.frame_us);
+        render_total += f.render_us;
+        pixel_bytes += f.pixel_bytes;
+        command_bytes += f.command_bytes;
+        windows += f.windows;
+        areas += f.areas;
+        merged += f.merged;
+        transactions += f.transactions;
+        heap_peak = std::max(heap_peak, f.heap_used);
+    }
+
+    uint32_t heap_total = 0;
+    uint32_t heap_used = lvgl_heap_used(&heap_total);
+
+    printf("{\n");
+    printf("  \"env\": \"native\",\n");
+    printf("  \"resolution\": [%d, %d],\n", (int)gfx.width(), (int)gfx.height());
+    printf("  \"duration_ms\": %u,\n", opts->duration_ms);
+    printf("  \"flush_mode\": \"%s\",\n", flush_mode_name());
+    printf("  \"render_mode\": \"%s\",\n", render_mode_name(draw_buffers_get_render_mode()));
+    printf("  \"draw_units\": %d,\n", LV_DRAW_SW_DRAW_UNIT_CNT);
+    printf("  \"bus_mhz\": %u,\n", opts->bus_mhz);
+    printf("  \"color_depth\": %d,\n", LV_COLOR_DEPTH);
+    printf("  \"pixel_pipeline\": \"%s\",\n", pixel_convert_pipeline_name(pixel_convert_get_pipeline()));
+    printf("  \"summary\": {\n");
+    printf("    \"loop_iterations\": %u,\n", iterations);
+    lvgl_task_stats_t task;
+    lvgl_task_get_stats(&task);
+    printf("    \"wakeups\": {\"timer\": %u, \"touch\": %u, \"app\": %u},\n",
+           task.timer_wakeups, task.touch_wakeups, task.app_wakeups);
+    power_manager_stats_t power;
+    power_manager_get_stats(&power);
+    printf("    \"power\": {\"state_ms\": {");
+    for (int p = 0; p < POWER_STATE_COUNT; p++) {
+        printf("%s\"%s\": %llu", p ? ", " : "", power_manager_state_name((power_state_t)p),
+               (unsigned long long)(power.state_us[p] / 1000));
+    }
+    printf("}, \"transitions\": %u, \"light_sleeps\": %u, \"light_sleep_ms\": %llu, \"duty_pct\": %.2f, "
+           "\"wakes\": %u, \"wake_latency_us\": {\"avg\": %u, \"max\": %u}, \"dropped_presses\": %u},\n",
+           power.transitions, power.light_sleeps, (unsigned long long)(power.light_sleep_us / 1000),
+           power.duty_x100 / 100.0, power.wakes, power.wake_latency_avg_us,
+           power.wake_latency_max_us, power.dropped_presses);
+    refresh_governor_stats_t refresh;
+    refresh_governor_get_stats(&refresh);
+    printf("    \"refresh\": {");
+    for (int l = 0; l < REFRESH_LEVEL_COUNT; l++) {
+        printf("\"%s\": {\"dwell_ms\": %llu, \"frames\": %u}, ", refresh_governor_level_name((refresh_level_t)l),
+               (unsigned long long)(refresh.dwell_us[l] / 1000), refresh.frames[l]);
+    }
+    printf("\"switches\": %u, \"boosts\": %u},\n", refresh.switches, refresh.boosts);
+    ui_command_stats_t cmds;
+    ui_command_get_stats(&cmds);
+    printf("    \"ui_commands\": {\"posted\": %u, \"applied\": %u, \"coalesced\": %u, \"dropped\": %u, "
+           "\"stale\": %u, \"budget_hits\": %u, \"latency_avg_us\": %u, \"latency_max_us\": %u},\n",
+           cmds.posted, cmds.applied, cmds.coalesced, cmds.dropped, cmds.stale, cmds.budget_hits,
+           cmds.latency_avg_us, cmds.latency_max_us);
+    // Counters start with the simulated clock at 0
+    perf_frame_counters_t frames_from = {};
+    perf_frame_counters_t frames_to;
+    perf_frame_rates_t rates;
+    perf_metrics_get_frame_counters(&frames_to);
+    perf_metrics_frame_rates(&frames_from, &frames_to, &rates);
+    printf("    \"frame_rates\": {\"refreshes\": %u, \"frames\": %u, \"fps\": %.2f, \"refreshes_per_s\": %.2f, "
+           "\"px_per_s\": %u, \"dirty_pct\": %.2f},\n",
+           frames_to.refreshes, frames_to.frames, rates.fps, rates.refreshes_per_s, rates.px_per_s, rates.dirty_pct);
+    printf("    \"perf\": {");
+    static perf_metric_snapshot_t perf;
+    for (int m = 0; m < PERF_METRIC_COUNT; m++) {
+        perf_metrics_snapshot((perf_metric_t)m, &perf);
+        printf("%s\"%s\": {\"count\": %u, \"avg\": %u, \"p50\": %u, \"p95\": %u, \"p99\": %u, \"max\": %u}",
+               m ? ", " : "", perf_metrics_name((perf_metric_t)m), perf.summary.count, perf.summary.avg_us,
+               perf.summary.p50_us, perf.summary.p95_us, perf.summary.p99_us, perf.summary.max_us);
+    }
+    printf("},\n");
+    printf("    \"rendered_frames\": %zu,\n", frames.size());
+    printf("    \"render_us\": {\"avg\": %llu, \"p50\": %u, \"p95\": %u, \"p99\": %u, \"max\": %u},\n",
+           frames.empty() ? 0ULL : (unsigned long long)(render_total / frames.size()),
+           percentile(render_times, 50), percentile(render_times, 95),
+           percentile(render_times, 99), percentile(render_times, 100));
+    printf("    \"frame_us\": {\"p50\": %u, \"p95\": %u, \"max\": %u},\n",
+           percentile(frame_times, 50), percentile(frame_times, 95), percentile(frame_times, 100));
+    printf("    \"bus_busy_us\": %llu,\n", (unsigned long long)gfx.getHostBusStats().bus_busy_us);
+    printf("    \"flushed_pixel_bytes\": %llu,\n", (unsigned long long)pixel_bytes);
+    printf("    \"flushed_command_bytes\": %llu,\n", (unsigned long long)command_bytes);
+    printf("    \"flush_windows\": %u,\n", windows);
+#if LVGL_FLUSH_MODE == LVGL_FLUSH_PIPELINE
+    flush_pipeline_stats_t pipe;
+    flush_pipeline_get_stats(&pipe);
+    printf("    \"pipeline\": {\"jobs\": %u, \"max_depth\": %u, \"flush_busy_us\": %llu},\n",
+           pipe.jobs, pipe.max_depth, (unsigned long long)pipe.flush_busy_us);
+#endif
+    flush_encoder_stats_t enc;
+    flush_encoder_get_stats(&enc);
+    printf("    \"encoder\": {\"areas\": %u, \"uniform_areas\": %u, \"fill_ops\": %u, \"raw_ops\": %u, "
+           "\"fill_pixels\": %llu, \"raw_pixels\": %llu},\n",
+           enc.areas, enc.uniform_areas, enc.fill_ops, enc.raw_ops,
+           (unsigned long long)enc.fill_pixels, (unsigned long long)enc.raw_pixels);
+    shadow_fb_stats_t shadow;
+    shadow_fb_get_stats(&shadow);
+    printf("    \"shadow\": {\"mode\": %d, \"bytes_sent\": %llu, \"bytes_skipped\": %llu, "
+           "\"rows_sent\": %u, \"rows_skipped\": %u},\n",
+           shadow_fb_get_mode(), (unsigned long long)shadow.bytes_sent,
+           (unsigned long long)shadow.bytes_skipped, shadow.rows_sent, shadow.rows_skipped);
+    draw_buffers_config_t bufs;
+    draw_buffers_get_config(&bufs);
+    printf("    \"draw_buffers\": {\"rows\": %u, \"bytes\": %u, \"double\": %s, \"dma\": %s, "
+           "\"fallback_steps\": %u, \"calibrated\": %s, \"render_us\": %u, \"flush_us\": %u},\n",
+           bufs.rows, bufs.bytes, bufs.double_buffered ? "true" : "false",
+           bufs.dma_capable ? "true" : "false", bufs.fallback_steps,
+           bufs.calibrated ? "true" : "false", bufs.render_us, bufs.flush_us);
+    printf("    \"scheduler\": {\"areas\": %u, \"merged\": %u, \"transactions\": %u},\n",
+           areas, merged, transactions);
+    touch_sampler_stats_t touch;
+    touch_sampler_get_stats(&touch);
+    printf("    \"touch\": {\"wakeups\": %u, \"reads\": %u, \"samples\": %u, \"dropped\": %u},\n",
+           touch.wakeups, touch.reads, touch.samples, touch.dropped);
+    touch_predict_stats_t predict;
+    touch_predict_get_stats(&predict);
+    printf("    \"predict\": {\"enabled\": %s, \"predicted\": %u, \"slow\": %u, \"evaluated\": %u, "
+           "\"err_avg_px\": %.2f, \"err_max_px\": %.2f, \"lag_avg_px\": %.2f},\n",
+           touch_predict_is_enabled() ? "true" : "false", predict.predicted, predict.slow,
+           predict.evaluated, predict.err_avg_px, predict.err_max_px, predict.lag_avg_px);
+    touch_gesture_stats_t gestures;
+    touch_gesture_get_stats(&gestures);
+    printf("    \"gestures\": {");
+    for (int g = 0; g < TOUCH_GESTURE_TYPE_COUNT; g++) {
+        printf("\"%s\": %u, ", touch_gesture_type_name((touch_gesture_type_t)g), gestures.recognized[g]);
+    }
+    printf("\"delivered\": %u},\n", gestures.delivered);
+    input_record_stats_t rec;
+    input_record_get_stats(&rec);
+    printf("    \"input\": {\"replayed\": %u, \"late_avg_ms\": %u, \"late_max_ms\": %u, \"recorded\": %u, \"dropped\": %u},\n",
+           rec.replayed, rec.late_avg_ms, rec.late_max_ms, rec.recorded, rec.dropped);
+    printf("    \"bus\": {");
+    for (int c = 0; c < BUS_CLIENT_COUNT; c++) {
+        bus_client_stats_t bus;
+        bus_arbiter_get_stats((bus_client_t)c, &bus);
+        printf("\"%s\": {\"transactions\": %u, \"busy_us\": %llu, \"wait_us\": %llu, "
+               "\"max_wait_us\": %u, \"yields\": %u}%s",
+               bus_arbiter_client_name((bus_client_t)c), bus.transactions,
+               (unsigned long long)bus.busy_us, (unsigned long long)bus.wait_us,
+               bus.max_wait_us, bus.yields, c + 1 < BUS_CLIENT_COUNT ? ", " : "");
+    }
+    printf("},\n");
+    printf("    \"latency\": {");
+    for (int k = 0; k < TOUCH_LATENCY_KIND_COUNT; k++) {
+        touch_latency_stats_t lat;
+        touch_latency_get_stats((touch_latency_kind_t)k, &lat);
+        printf("\"%s\": {\"count\": %u, \"timeouts\": %u, \"avg_us\": %u, \"max_us\": %u, "
+               "\"dispatch_us\": %u, \"render_us\": %u, \"flush_us\": %u, \"buckets\": [",
+               touch_latency_kind_name((touch_latency_kind_t)k), lat.count, lat.timeouts,
+               lat.total_avg_us, lat.total_max_us, lat.dispatch_avg_us, lat.render_avg_us, lat.flush_avg_us);
+        for (int b = 0; b < TOUCH_LATENCY_BUCKETS; b++) {
+            printf("%u%s", lat.buckets[b], b + 1 < TOUCH_LATENCY_BUCKETS ? ", " : "");
+        }
+        printf("]}%s", k + 1 < TOUCH_LATENCY_KIND_COUNT ? ", " : "");
+    }
+    printf("},\n");
+    printf("    \"lvgl_heap\": {\"used\": %u, \"peak\": %u, \"total\": %u}\n", heap_used, heap_peak, heap_total);
+    printf("  }%s\n", opts->summary_only ? "" : ",");
+
+    if (!opts->summary_only) {
+        printf("  \"frames\": [\n");
+        for (size_t i = 0; i < frames.size(); i++) {
+            const bench_frame_t& f = frames[i];
+            printf("    {\"t_ms\": %u, \"step\": \"%s\", \"render_us\": %u, \"frame_us\": %u, "
+                   "\"pixel_bytes\": %llu, \"command_bytes\": %llu, \"windows\": %u, \"areas\": %u, "
+                   "\"merged\": %u, \"transactions\": %u, \"heap_used\": %u}%s\n",
+                   f.t_ms, f.step, f.render_us, f.frame_us, (unsigned long long)f.pixel_bytes,
+                   (unsigned long long)f.command_bytes, f.windows, f.areas, f.merged,
+                   f.transactions, f.heap_used,
+                   i + 1 < frames.size() ? "," : "");
+        }
+        printf("  ]\n");
+    }
+    printf("}\n");
+}
+
+int main(int argc, char** argv) {
+    bench_options_t opts;
+    if (!parse_options(argc, argv, &opts)) {
+        return 1;
+    }
+
+    init_display();
+    gfx.setHostBusFrequency(opts.bus_mhz * 1000000);
+    init_touch();
+    lvgl_task_init();
+    init_lvgl_display();
+    init_lvgl_input_device();
+    power_manager_init();
+
+    if (opts.bench_pixels > 0) {
+        return run_pixel_benchmark(&opts);
+    }
+
+    lv_obj_t *screen = lv_display_get_screen_active(disp);
+    lv_obj_set_style_base_dir(screen, LV_BASE_DIR_RTL, 0);
+    lv_obj_t *tabview = create_hebrew_tabview(screen);
+    if (opts.rotation >= 0) {
+        lvgl_set_rotation((uint8_t)opts.rotation);
+    }
+    lv_obj_update_layout(screen);
+
+    if (opts.bench_touch_filter) {
+        return bench_touch_filter_run(tabview, opts.trace_path);
+    }
+
+    if (opts.replay_path) {
+        if (!input_replay_start(indev, opts.replay_path)) return 1;
+        if (opts.duration_ms == 0) {
+            input_record_stats_t rec;
+            input_record_get_stats(&rec);
+            opts.duration_ms = rec.replay_ms + REPLAY_SETTLE_MS;
+        }
+    } else {
+        bench_scenario_build(tabview);
+        if (opts.duration_ms == 0) {
+            opts.duration_ms = bench_scenario_period_ms();
+        }
+    }
+    if (opts.record_path) {
+        input_record_start();
+    }
+    ESP_LOGI(TAG, "Running %u ms of simulated time", opts.duration_ms);
+
+    std::vector<bench_frame_t> frames;
+    uint32_t iterations = 0;
+
+    while ((uint32_t)(esp_timer_get_time() / 1000) < opts.duration_ms) {
+        uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+        if (!opts.replay_path) {
+            bench_scenario_update(now_ms);
+        }
+
+        ui_command_drain();
+
+        host_bus_stats_t before = gfx.getHostBusStats();
+        flush_scheduler_stats_t sched_before;
+        flush_scheduler_get_stats(&sched_before);
+        auto render_start = std::chrono::steady_clock::now();
+        uint32_t next_timer_ms = lv_timer_handler();
+        auto render_end = std::chrono::steady_clock::now();
+        auto frame_end = std::max(render_end, gfx.getHostDmaDoneAt());
+        perf_metrics_record(PERF_TIMER_HANDLER, (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+            render_end - render_start).count());
+        const host_bus_stats_t& after = gfx.getHostBusStats();
+        iterations++;
+
+        flush_scheduler_stats_t sched;
+        flush_scheduler_get_stats(&sched);
+
+        // Only iterations that flushed something count as frames
+        if (sched.frames != sched_before.frames) {
+            bench_frame_t frame;
+            frame.t_ms = now_ms;
+            frame.render_us = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                render_end - render_start).count();
+            frame.frame_us = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                frame_end - render_start).count();
+            frame.pixel_bytes = after.pixel_bytes - before.pixel_bytes;
+            frame.command_bytes = after.command_bytes - before.command_bytes;
+            frame.windows = after.windows - before.windows;
+            frame.areas = sched.total_areas - sched_before.total_areas;
+            frame.merged = sched.total_merged - sched_before.total_merged;
+            frame.transactions = sched.total_transactions - sched_before.total_transactions;
+            frame.heap_used = lvgl_heap_used(NULL);
+            frame.step = opts.replay_path ? "replay" : bench_scenario_current_label();
+            frames.push_back(frame);
+        }
+
+        lv_lock();
+        power_manager_update();
+        refresh_governor_update();
+        lv_unlock();
+
+        // Same as loop(): sleep until the next LVGL timer, or until the
+        // script touches the panel (the touch wake on the device)
+        if (!opts.replay_path) {
+            next_timer_ms = std::min(next_timer_ms, bench_scenario_next_ms(now_ms));
+        }
+        lvgl_task_wait(next_timer_ms);
+    }
+
+    if (opts.record_path && !input_record_stop(opts.record_path)) {
+        return 1;
+    }
+
+    print_report(&opts, iterations, frames);
+    return 0;
+}
@@ -0,0 +1,213 @@
+#include "bench_scenario.hpp"
+#include "display.hpp"
+#include "lvgl_task.hpp"
+#include "lv_expandable_card.h"
+#include "lv_image_gallery.h"
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+// Script timing in milliseconds
+#define SCENARIO_BOOT_MS 1000
+#define SCENARIO_TAB_SLOT_MS 1600
+#define SCENARIO_TAP_MS 80
+#define SCENARIO_DRAG_MS 300
+#define SCENARIO_DRAG_STEP_MS 10
+#define SCENARIO_SETTLE_MS 1000
+
+typedef struct {
+    uint32_t at_ms;
+    bool is_touch;
+    bool pressed;
+    int32_t x;
+    int32_t y;
+    std::function<lv_obj_t*(void)> target;  // Resolved at fire time; overrides x/y
+    std::function<void(void)> action;
+    const char* label;
+} bench_step_t;
+
+static std::vector<bench_step_t> steps;
+static uint32_t period_ms = SCENARIO_BOOT_MS;
+static size_t next_step = 0;
+static uint32_t last_local_ms = 0;
+static const char* current_label = "idle";
+
+static void add_touch(uint32_t at_ms, bool pressed, int32_t x, int32_t y, const char* label) {
+    bench_step_t step = {};
+    step.at_ms = at_ms;
+    step.is_touch = true;
+    step.pressed = pressed;
+    step.x = x;
+    step.y = y;
+    step.label = label;
+    steps.push_back(step);
+}
+
+static void add_tap_obj(uint32_t at_ms, std::function<lv_obj_t*(void)> target, const char* label) {
+    bench_step_t press = {};
+    press.at_ms = at_ms;
+    press.is_touch = true;
+    press.pressed = true;
+    press.target = target;
+    press.label = label;
+    steps.push_back(press);
+
+    add_touch(at_ms + SCENARIO_TAP_MS, false, 0, 0, label);
+}
+
+static void add_drag(uint32_t at_ms, int32_t x0, int32_t y0, int32_t x1, int32_t y1, const char* label) {
+    const int32_t n = SCENARIO_DRAG_MS / SCENARIO_DRAG_STEP_MS;
+    for (int32_t i = 0; i <= n; i++) {
+        add_touch(at_ms + i * SCENARIO_DRAG_STEP_MS, true,
+                  x0 + (x1 - x0) * i / n, y0 + (y1 - y0) * i / n, label);
+    }
+    add_touch(at_ms + SCENARIO_DRAG_MS + SCENARIO_DRAG_STEP_MS, false, 0, 0, label);
+}
+
+static void add_action(uint32_t at_ms, std::function<void(void)> action, const char* label) {
+    bench_step_t step = {};
+    step.at_ms = at_ms;
+    step.is_touch = false;
+    step.action = action;
+    step.label = label;
+    steps.push_back(step);
+}
+
+// Settings modal layout: overlay -> modal -> {header, content}
+static lv_obj_t* settings_overlay(void) {
+    lv_obj_t *screen = lv_screen_active();
+    return lv_obj_get_child(screen, (int32_t)lv_obj_get_child_count(screen) - 1);
+}
+
+static lv_obj_t* settings_close_button(void) {
+    lv_obj_t *header = lv_obj_get_child(lv_obj_get_child(settings_overlay(), 0), 0);
+    return lv_obj_get_child(header, 1);
+}
+
+static lv_obj_t* settings_dark_mode_switch(void) {
+    lv_obj_t *content = lv_obj_get_child(lv_obj_get_child(settings_overlay(), 0), 1);
+    lv_obj_t *dark_mode_row = lv_obj_get_child(content, 1);
+    return lv_obj_get_child(dark_mode_row, 1);
+}
+
+void bench_scenario_build(lv_obj_t *tabview) {
+    static const char* tab_labels[] = {"tab_main", "tab_news", "tab_niqqud", "tab_pull", "tab_gallery"};
+
+    steps.clear();
+    next_step = 0;
+    last_local_ms = 0;
+    current_label = "idle";
+
+    lv_obj_t *screen = lv_screen_active();
+    lv_obj_t *tab_bar = lv_tabview_get_tab_bar(tabview);
+    lv_obj_t *settings_btn = lv_obj_get_child(screen, (int32_t)lv_obj_get_child_count(screen) - 1);
+
+    // Drags are placed relative to the screen so they work in either orientation
+    lv_display_t *display = lv_display_get_default();
+    const int32_t cx = lv_display_get_horizontal_resolution(display) / 2;
+    const int32_t h = lv_display_get_vertical_resolution(display);
+    uint32_t t = SCENARIO_BOOT_MS;
+
+    uint32_t tab_count = lv_tabview_get_tab_count(tabview);
+    for (uint32_t i = 0; i < tab_count && i < 5; i++) {
+        lv_obj_t *button = lv_obj_get_child(tab_bar, (int32_t)i);
+
+        // The tab bar scrolls horizontally; bring the button on screen before tapping it
+        add_action(t, [button]() { lv_obj_scroll_to_view(button, LV_ANIM_OFF); }, tab_labels[i]);
+        add_tap_obj(t + 100, [button]() { return button; }, tab_labels[i]);
+
+        // Clicks timed by touch_latency besides the tab buttons
+        lv_obj_t *page = lv_obj_get_child(lv_tabview_get_content(tabview), (int32_t)i);
+        lv_obj_t *button_in_page = NULL;
+        const char *button_label = NULL;
+        if (i == 1) {
+            // News: page -> container -> {title, cards...}
+            button_in_page = lv_expandable_card_get_expand_button(lv_obj_get_child(lv_obj_get_child(page, 0), 1));
+            button_label = "card_expand";
+        } else if (i == 4) {
+            button_in_page = lv_image_gallery_get_next_button(lv_obj_get_child(page, 0));
+            button_label = "gallery_next";
+        }
+        if (button_in_page) {
+            add_action(t + 300, [button_in_page]() { lv_obj_scroll_to_view_recursive(button_in_page, LV_ANIM_OFF); },
+                       button_label);
+            add_tap_obj(t + 400, [button_in_page]() { return button_in_page; }, button_label);
+        }
+
+        if (i == 3) {
+            // Pull-to-refresh tab: drag down past the threshold
+            add_drag(t + 600, cx, h / 4, cx, h * 3 / 4, "pull_refresh");
+        } else {
+            add_drag(t + 600, cx, h * 5 / 6, cx, h * 7 / 24, "scroll");
+        }
+        t += SCENARIO_TAB_SLOT_MS;
+    }
+
+    add_tap_obj(t, [settings_btn]() { return settings_btn; }, "settings_open");
+    t += SCENARIO_SETTLE_MS;
+    add_tap_obj(t, settings_dark_mode_switch, "theme_dark");
+    t += SCENARIO_SETTLE_MS;
+    add_tap_obj(t, settings_dark_mode_switch, "theme_light");
+    t += SCENARIO_SETTLE_MS;
+    add_tap_obj(t, settings_close_button, "settings_close");
+    t += SCENARIO_SETTLE_MS;
+
+    // Return to the first tab so the next pass starts from the same state
+    lv_obj_t *first_button = lv_obj_get_child(tab_bar, 0);
+    add_action(t, [first_button]() { lv_obj_scroll_to_view(first_button, LV_ANIM_OFF); }, "reset");
+    add_tap_obj(t + 100, [first_button]() { return first_button; }, "reset");
+    t += SCENARIO_SETTLE_MS;
+
+    std::stable_sort(steps.begin(), steps.end(),
+                     [](const bench_step_t &a, const bench_step_t &b) { return a.at_ms < b.at_ms; });
+    period_ms = t;
+}
+
+uint32_t bench_scenario_period_ms(void) {
+    return period_ms;
+}
+
+void bench_scenario_update(uint32_t now_ms) {
+    uint32_t local_ms = now_ms % period_ms;
+    if (local_ms < last_local_ms) {
+        next_step = 0;  // Wrapped into the next pass
+    }
+    last_local_ms = local_ms;
+
+    while (next_step < steps.size() && steps[next_step].at_ms <= local_ms) {
+        const bench_step_t &step = steps[next_step++];
+        current_label = step.label;
+
+        if (!step.is_touch) {
+            step.action();
+            continue;
+        }
+
+        int32_t x = step.x;
+        int32_t y = step.y;
+        if (step.target) {
+            lv_obj_t *obj = step.target();
+            if (!obj) continue;
+            lv_area_t coords;
+            lv_obj_get_coords(obj, &coords);
+            x = (coords.x1 + coords.x2) / 2;
+            y = (coords.y1 + coords.y2) / 2;
+        }
+        gfx.setHostTouch(step.pressed, x, y);
+        // What the pen-down interrupt and the sampling task do on the device
+        lvgl_task_wake(LVGL_TASK_WAKE_TOUCH);
+    }
+}
+
+uint32_t bench_scenario_next_ms(uint32_t now_ms) {
+    uint32_t local_ms = now_ms % period_ms;
+    if (next_step == steps.size()) {
+        return period_ms - local_ms;  // First step of the next pass
+    }
+    uint32_t at_ms = steps[next_step].at_ms;
+    return at_ms > local_ms ? at_ms - local_ms : 0;
+}
+
+const char* bench_scenario_current_label(void) {
+    return current_label;
+}
@@ -0,0 +1,32 @@
+#ifndef BENCH_SCENARIO_HPP
+#define BENCH_SCENARIO_HPP
+
+#include <lvgl.h>
+#include <stdint.h>
+
+/**
+ * Scripted user session for the host benchmark
+ *
+ * Taps every tab, expands a news card, steps the gallery, scrolls each tab's
+ * content, pulls to refresh, opens the settings modal and toggles the theme
+ * twice. Touches are fed through the stub LGFX
+ * so they travel the same touch_read_callback path as on the device.
+ * The script repeats when the run is longer than one pass.
+ */
+
+// Build the script against the live UI (call after create_hebrew_tabview)
+void bench_scenario_build(lv_obj_t *tabview);
+
+// Length of one pass through the script in milliseconds
+uint32_t bench_scenario_period_ms(void);
+
+// Apply every step due at the given simulated time; touches wake the LVGL task
+void bench_scenario_update(uint32_t now_ms);
+
+// Milliseconds from now_ms until the next step is due
+uint32_t bench_scenario_next_ms(uint32_t now_ms);
+
+// Label of the most recently applied step ("idle" before the first)
+const char* bench_scenario_current_label(void);
+
+#endif // BENCH_SCENARIO_HPP
@@ -0,0 +1,220 @@
+#include "bench_touch_filter.hpp"
+#include "display.hpp"
+#include "lvgl_setup.hpp"
+#include "touch_filter.hpp"
+#include "flush_scheduler.hpp"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Niqqud text tab: scrolls vertically and has nothing clickable under the finger
+#define TRACE_TAB 2
+#define TRACE_SAMPLE_MS 10
+#define TRACE_HOLD_MS 1500
+#define TRACE_SETTLE_MS 600
+// Fixed loop cadence, so every configuration sees the trace read at the same times
+#define TRACE_STEP_MS 5
+
+typedef struct {
+    uint32_t t_ms;
+    bool pressed;
+    int16_t x;
+    int16_t y;
+} trace_point_t;
+
+typedef struct {
+    std::string name;
+    std::vector<trace_point_t> points;
+} trace_t;
+
+typedef struct {
+    const char* name;
+    touch_filter_config_t config;
+} filter_case_t;
+
+typedef struct {
+    uint32_t frames;
+    uint32_t areas;
+    uint64_t pixel_bytes;
+    uint32_t scroll_events;
+} replay_result_t;
+
+static uint32_t rng_state = 1;
+static uint32_t scroll_events = 0;
+
+static int32_t rng_range(int32_t lo, int32_t hi) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return lo + (int32_t)((rng_state >> 8) % (uint32_t)(hi - lo + 1));
+}
+
+/**
+ * Finger resting at (x, y): triangular noise of +-amplitude, three times
+ * wider while the pressure settles at press and release, and roughly one
+ * spike of up to 12 px every spike_every samples
+ */
+static trace_t make_hold_trace(const char* name, int16_t x, int16_t y,
+                               int32_t amplitude, int32_t spike_every, uint32_t seed) {
+    trace_t trace;
+    trace.name = name;
+    rng_state = seed;
+
+    for (uint32_t ms = 0; ms < TRACE_HOLD_MS; ms += TRACE_SAMPLE_MS) {
+        int32_t a = (ms < 40 || ms + 40 >= TRACE_HOLD_MS) ? amplitude * 3 : amplitude;
+        int32_t dx = (rng_range(-a, a) + rng_range(-a, a)) / 2;
+        int32_t dy = (rng_range(-a, a) + rng_range(-a, a)) / 2;
+        if (spike_every > 0 && rng_range(0, spike_every - 1) == 0) {
+            dx += rng_range(-12, 12);
+            dy += rng_range(-12, 12);
+        }
+        trace.points.push_back({ms, true, (int16_t)(x + dx), (int16_t)(y + dy)});
+    }
+    trace.points.push_back({TRACE_HOLD_MS, false, x, y});
+    return trace;
+}
+
+// Samples from a device log taken with TOUCH_TRACE_LOG=1, times rebased to 0
+static bool load_trace(const char* path, trace_t *trace) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Cannot open trace %s\n", path);
+        return false;
+    }
+
+    const char *slash = strrchr(path, '/');
+    trace->name = slash ? slash + 1 : path;
+    trace->points.clear();
+
+    char line[256];
+    unsigned long t0 = 0;
+    while (fgets(line, sizeof(line), f)) {
+        const char *p = strstr(line, "TRACE,");
+        unsigned long t;
+        int pressed, x, y;
+        if (!p || sscanf(p, "TRACE,%lu,%d,%d,%d", &t, &pressed, &x, &y) != 4) continue;
+        if (trace->points.empty()) t0 = t;
+        trace->points.push_back({(uint32_t)(t - t0), pressed != 0, (int16_t)x, (int16_t)y});
+    }
+    fclose(f);
+
+    if (trace->points.empty()) {
+        fprintf(stderr, "No TRACE lines in %s\n", path);
+        return false;
+    }
+    return true;
+}
+
+static void scroll_event_cb(lv_event_t *e) {
+    (void)e;
+    scroll_events++;
+}
+
+static void run_for(uint32_t ms) {
+    for (uint32_t t = 0; t < ms; t += TRACE_STEP_MS) {
+        lv_timer_handler();
+        esp_timer_host_advance(TRACE_STEP_MS * 1000);
+    }
+}
+
+static replay_result_t replay(lv_obj_t *page, const trace_t &trace) {
+    // Same starting point for every run
+    gfx.setHostTouch(false, 0, 0);
+    lv_obj_scroll_to_y(page, 0, LV_ANIM_OFF);
+    run_for(TRACE_SETTLE_MS);
+
+    flush_scheduler_stats_t before;
+    flush_scheduler_get_stats(&before);
+    uint64_t bytes_before = gfx.getHostBusStats().pixel_bytes;
+    scroll_events = 0;
+
+    size_t next = 0;
+    uint32_t end_ms = trace.points.back().t_ms + TRACE_SETTLE_MS;
+    for (uint32_t t = 0; t <= end_ms; t += TRACE_STEP_MS) {
+        while (next < trace.points.size() && trace.points[next].t_ms <= t) {
+            const trace_point_t &p = trace.points[next++];
+            gfx.setHostTouch(p.pressed, p.x, p.y);
+        }
+        lv_timer_handler();
+        esp_timer_host_advance(TRACE_STEP_MS * 1000);
+    }
+    gfx.setHostTouch(false, 0, 0);
+    run_for(TRACE_SETTLE_MS);
+
+    flush_scheduler_stats_t after;
+    flush_scheduler_get_stats(&after);
+
+    replay_result_t result;
+    result.frames = after.frames - before.frames;
+    result.areas = after.total_areas - before.total_areas;
+    result.pixel_bytes = gfx.getHostBusStats().pixel_bytes - bytes_before;
+    result.scroll_events = scroll_events;
+    return result;
+}
+
+int bench_touch_filter_run(lv_obj_t *tabview, const char *trace_path) {
+    lv_tabview_set_active(tabview, TRACE_TAB, LV_ANIM_OFF);
+    lv_obj_t *page = lv_obj_get_child(lv_tabview_get_content(tabview), TRACE_TAB);
+    lv_obj_add_event_cb(page, scroll_event_cb, LV_EVENT_SCROLL, NULL);
+    run_for(TRACE_SETTLE_MS);
+
+    lv_area_t area;
+    lv_obj_get_coords(page, &area);
+    int16_t cx = (int16_t)((area.x1 + area.x2) / 2);
+    int16_t cy = (int16_t)((area.y1 + area.y2) / 2);
+
+    std::vector<trace_t> traces;
+    traces.push_back(make_hold_trace("hold", cx, cy, 2, 25, 1));
+    traces.push_back(make_hold_trace("hold_noisy", cx, cy, 4, 10, 2));
+    if (trace_path) {
+        trace_t recorded;
+        if (!load_trace(trace_path, &recorded)) return 1;
+        traces.push_back(recorded);
+    }
+
+    // The unfiltered case must stay first: it is the baseline
+    const filter_case_t cases[] = {
+        {"raw",      {1, 256, 0}},
+        {"median3",  {3, 256, 0}},
+        {"median5",  {5, 256, 0}},
+        {"iir",      {1, 96, 0}},
+        {"deadzone", {1, 256, 3}},
+        {"default",  {TOUCH_FILTER_MEDIAN, TOUCH_FILTER_IIR_ALPHA, TOUCH_FILTER_DEADZONE_PX}},
+        {"strong",   {5, 96, 3}},
+    };
+    const size_t num_cases = sizeof(cases) / sizeof(cases[0]);
+
+    touch_filter_config_t saved;
+    touch_filter_get_config(&saved);
+
+    printf("{\n");
+    printf("  \"env\": \"native\",\n");
+    printf("  \"touch_filter\": [\n");
+    for (size_t t = 0; t < traces.size(); t++) {
+        const trace_t &trace = traces[t];
+        printf("    {\"trace\": \"%s\", \"samples\": %zu, \"duration_ms\": %u, \"results\": [\n",
+               trace.name.c_str(), trace.points.size(), trace.points.back().t_ms);
+
+        replay_result_t baseline = {0, 0, 0, 0};
+        for (size_t c = 0; c < num_cases; c++) {
+            touch_filter_set_config(&cases[c].config);
+            replay_result_t r = replay(page, trace);
+            if (c == 0) baseline = r;
+
+            printf("      {\"config\": \"%s\", \"median\": %u, \"iir_alpha\": %u, \"deadzone_px\": %u, "
+                   "\"frames\": %u, \"areas\": %u, \"pixel_bytes\": %llu, \"scroll_events\": %u, "
+                   "\"avoided_frames\": %d, \"avoided_areas\": %d}%s\n",
+                   cases[c].name, cases[c].config.median, cases[c].config.iir_alpha,
+                   cases[c].config.deadzone_px, r.frames, r.areas,
+                   (unsigned long long)r.pixel_bytes, r.scroll_events,
+                   (int)baseline.frames - (int)r.frames, (int)baseline.areas - (int)r.areas,
+                   c + 1 < num_cases ? "," : "");
+        }
+        printf("    ]}%s\n", t + 1 < traces.size() ? "," : "");
+    }
+    printf("  ]\n");
+    printf("}\n");
+
+    touch_filter_set_config(&saved);
+    return 0;
+}
@@ -0,0 +1,23 @@
+#ifndef BENCH_TOUCH_FILTER_HPP
+#define BENCH_TOUCH_FILTER_HPP
+
+#include <lvgl.h>
+
+/**
+ * Touch filter benchmark for the host build
+ *
+ * Replays jitter traces of a finger resting on a scrollable tab through the
+ * real sampler -> filter -> touch_read_callback path, once per filter
+ * configuration, and counts what reached the panel. A resting finger should
+ * redraw nothing, so every frame, area and byte is a spurious invalidation;
+ * "avoided" is the difference to the unfiltered run.
+ *
+ * Built-in traces are generated (seeded, reproducible). Traces recorded on
+ * the device with -D TOUCH_TRACE_LOG=1 can be added: every log line
+ * containing "TRACE,t_ms,pressed,x,y" is one sample.
+ */
+
+// Print the results as JSON on stdout; returns the process exit code
+int bench_touch_filter_run(lv_obj_t *tabview, const char *trace_path);
+
+#endif // BENCH_TOUCH_FILTER_HPP
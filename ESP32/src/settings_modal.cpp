@@ -3,6 +3,7 @@
 #include "hebrew_fonts.h"
 #include "theme_manager.h"
 #include "ui_helpers.h"
+#include "power_manager.hpp"
 #include <Arduino.h>
 
 // External functions from main.cpp
@@ -11,12 +12,6 @@ extern bool is_fps_display_enabled();
 
 static const char* TAG = "SETTINGS_MODAL";
 
-// Backlight configuration
-#define TFT_BL_PIN 32        // Backlight pin - change to your actual pin
-#define PWM_CHANNEL 0        // PWM channel
-#define PWM_FREQ 5000        // PWM frequency
-#define PWM_RESOLUTION 8     // 8-bit resolution (0-255)
-
 // Callback type for theme toggle
 typedef void (*theme_toggle_callback_t)(void);
 static theme_toggle_callback_t g_theme_toggle_cb = NULL;
@@ -52,12 +47,11 @@ static void brightness_slider_event_cb(lv_event_t *e) {
     brightness_level = lv_slider_get_value(slider);
     lv_label_set_text_fmt(label, "%d%%", brightness_level);
     
-    // Actually set hardware backlight brightness via PWM
-    // Map 0-100 to 0-255 for PWM
+    // Map 0-100 to 0-255 for the LovyanGFX backlight PWM
     uint8_t pwm_value = (brightness_level * 255) / 100;
     
-    // Set PWM duty cycle
-    ledcWrite(PWM_CHANNEL, pwm_value);
+    // Through the power manager, which dims relative to this level
+    power_manager_set_brightness(pwm_value);
     
     ESP_LOGI(TAG, "Brightness: %d%% (PWM: %d)", brightness_level, pwm_value);
 }
@@ -124,18 +118,6 @@ static lv_obj_t* create_setting_row_with_switch(lv_obj_t *parent, const char *ti
 void create_settings_modal(lv_obj_t *parent, theme_toggle_callback_t theme_cb) {
     g_theme_toggle_cb = theme_cb;
     
-    // Initialize backlight PWM if not already done
-    static bool pwm_initialized = false;
-    if (!pwm_initialized) {
-        ledcSetup(PWM_CHANNEL, PWM_FREQ, PWM_RESOLUTION);
-        ledcAttachPin(TFT_BL_PIN, PWM_CHANNEL);
-        // Set initial brightness
-        uint8_t initial_pwm = (brightness_level * 255) / 100;
-        ledcWrite(PWM_CHANNEL, initial_pwm);
-        pwm_initialized = true;
-        ESP_LOGI(TAG, "Backlight PWM initialized on pin %d", TFT_BL_PIN);
-    }
-
     // Create modal background overlay
     lv_obj_t *overlay = lv_obj_create(parent);
     lv_obj_set_size(overlay, LV_PCT(100), LV_PCT(100));
@@ -1,6 +1,8 @@
 #include <lvgl.h>
 #include "esp_log.h"
 #include "lv_image_gallery.h"
+#include "touch_latency.hpp"
+#include "touch_gesture.hpp"
 #include "../ui_config/hebrew_widget_config.h"
 
 static const char* TAG = "GALLERY_TEST";
@@ -17,6 +19,21 @@ static lv_gallery_image_t gallery_images[] = {
     {&image_3, "תמונה 3", 0xFF5722}, // Orange
 };
 
+// Swipe through the images like the navigation buttons, mirrored for RTL
+static void gallery_swipe_cb(lv_obj_t* gallery, const touch_gesture_t* gesture, void* user_data) {
+    (void)user_data;
+    if (gesture->dir != TOUCH_GESTURE_DIR_LEFT && gesture->dir != TOUCH_GESTURE_DIR_RIGHT) return;
+
+    bool rtl = lv_obj_get_style_base_dir(gallery, LV_PART_MAIN) == LV_BASE_DIR_RTL;
+    if ((gesture->dir == TOUCH_GESTURE_DIR_LEFT) != rtl) {
+        lv_image_gallery_next(gallery);
+    } else {
+        lv_image_gallery_prev(gallery);
+    }
+    ESP_LOGI(TAG, "Gallery %s, showing image %d", touch_gesture_type_name(gesture->type),
+             lv_image_gallery_get_index(gallery) + 1);
+}
+
 void create_gallery_tab(lv_obj_t* tab) {
     ESP_LOGI(TAG, "Creating gallery test tab with reusable widget");
 
@@ -33,6 +50,8 @@ void create_gallery_tab(lv_obj_t* tab) {
     );
 
     if (gallery) {
+        touch_latency_track(lv_image_gallery_get_next_button(gallery), gallery, TOUCH_LATENCY_GALLERY_NEXT);
+        touch_gesture_subscribe(gallery, TOUCH_GESTURE_MASK_SWIPES, gallery_swipe_cb, NULL);
         ESP_LOGI(TAG, "Gallery widget created successfully");
     } else {
         ESP_LOGE(TAG, "Failed to create gallery widget");
@@ -4,6 +4,7 @@
 #include "lv_expandable_card.h"
 #include "../ui_config/hebrew_widget_config.h"
 #include "ui_helpers.h"
+#include "touch_latency.hpp"
 
 // Layout constants
 #define NEWS_TAB_PADDING 15
@@ -42,12 +43,31 @@ static lv_card_data_t news_articles[] = {
     }
 };
 
+// Card list, for cards added later (news_tab_add_card)
+static lv_obj_t *news_container = NULL;
+
+static lv_obj_t* add_card(lv_obj_t *container, const lv_card_data_t *card_data, const lv_card_config_t *config) {
+    lv_obj_t* card = lv_expandable_card_create(container, card_data, config);
+    if (card) {
+        touch_latency_track(lv_expandable_card_get_expand_button(card), card, TOUCH_LATENCY_CARD_EXPAND);
+    }
+    return card;
+}
+
+lv_obj_t* news_tab_add_card(const lv_card_data_t *card_data) {
+    if (!news_container) return NULL;
+    static lv_card_config_t hebrew_config;
+    hebrew_config = hebrew_get_expandable_card_config();
+    return add_card(news_container, card_data, &hebrew_config);
+}
+
 void create_news_tab(lv_obj_t *tab) {
     // Set RTL base direction for the tab
     lv_obj_set_style_base_dir(tab, LV_BASE_DIR_RTL, 0);
 
     // Create standard Hebrew tab container (eliminates 15+ lines of repetitive code)
     lv_obj_t *container = ui_create_tab_container(tab, NEWS_TAB_PADDING);
+    news_container = container;
 
     // Create title using helper (eliminates style object repetition)
     lv_obj_t *title = ui_create_title_label(container, "חדשות וכתבות \"החמות ביותר\"");
@@ -73,15 +93,7 @@ void create_news_tab(lv_obj_t *tab) {
             config = &english_config;
         }
 
-        lv_obj_t* card = lv_expandable_card_create(
-            container,
-            &news_articles[i],
-            config  // Use custom config for English, NULL for Hebrew cards
-        );
-
-        if (!card) {
-            // Handle error - could log or continue with next article
-            continue;
-        }
+        // Custom config for English, Hebrew config for the rest; a failed card is skipped
+        add_card(container, &news_articles[i], config);
     }
 }
\ No newline at end of file
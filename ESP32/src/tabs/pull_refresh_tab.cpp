@@ -2,10 +2,18 @@
 #include <cstdlib>
 #include <ctime>
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "hebrew_fonts.h"
 #include "lv_pull_refresh.h"
 #include "../ui_config/hebrew_widget_config.h"
 #include "ui_helpers.h"
+#include "ui_command.h"
+
+// Simulated fetch time of a refresh
+#define FETCH_DELAY_MS 300
+
+// Wait before posting a fetch result again when the UI queue is full
+#define FETCH_RETRY_MS 50
 
 // Array of random Hebrew texts
 static const char* random_hebrew_texts[] = {
@@ -20,6 +28,7 @@ static const char* random_hebrew_texts[] = {
 
 static const int num_texts = sizeof(random_hebrew_texts) / sizeof(random_hebrew_texts[0]);
 static lv_obj_t* global_text_label = NULL;  // Global reference for callbacks
+static esp_timer_handle_t fetch_timer = NULL;
 
 // Initialize random seed once
 static void init_random_seed() {
@@ -30,33 +39,41 @@ static void init_random_seed() {
     }
 }
 
-// Generate and display random text
-static void update_random_text() {
-    if (!global_text_label) return;
+// Stand-in for a network fetch: runs in the esp_timer task, not the LVGL task,
+// so it hands its results to the UI through the command queue
+static void fetch_done_cb(void* arg) {
+    lv_obj_t* container = (lv_obj_t*)arg;
 
     init_random_seed();
     int random_index = rand() % num_texts;
-    lv_label_set_text(global_text_label, random_hebrew_texts[random_index]);
-    ESP_LOGI("RandomTab", "Random text updated: index %d", random_index);
-}
-
-// Timer callback for completing refresh
-static void refresh_complete_timer_cb(lv_timer_t* timer) {
-    lv_obj_t* container = (lv_obj_t*)lv_timer_get_user_data(timer);
-    lv_pull_refresh_complete(container);
-    lv_timer_delete(timer);
+    // The widget spins until it hears the refresh is done, so a result that
+    // does not fit in the queue is posted again rather than lost
+    if (!ui_command_set_text(global_text_label, random_hebrew_texts[random_index]) ||
+        !ui_command_pull_refresh_done(container)) {
+        ESP_LOGW("RandomTab", "UI queue full, posting the fetch again in %d ms", FETCH_RETRY_MS);
+        esp_timer_start_once(fetch_timer, FETCH_RETRY_MS * 1000);
+        return;
+    }
+    ESP_LOGI("RandomTab", "Random text fetched: index %d", random_index);
 }
 
 // Pull-to-refresh callback
 static void pull_refresh_callback(lv_obj_t* container, void* user_data) {
     ESP_LOGI("RandomTab", "Pull-to-refresh triggered!");
 
-    // Update random text
-    update_random_text();
-
-    // Simulate async operation with a small delay
-    lv_timer_t* complete_timer = lv_timer_create(refresh_complete_timer_cb, 300, container);
-    lv_timer_set_repeat_count(complete_timer, 1);
+    // One fetch at a time: the widget does not refresh again before it completes
+    if (!fetch_timer) {
+        esp_timer_create_args_t args = {};
+        args.callback = fetch_done_cb;
+        args.arg = container;
+        args.name = "fetch";
+        if (esp_timer_create(&args, &fetch_timer) != ESP_OK) {
+            ESP_LOGE("RandomTab", "Failed to create fetch timer");
+            lv_pull_refresh_complete(container);
+            return;
+        }
+    }
+    esp_timer_start_once(fetch_timer, FETCH_DELAY_MS * 1000);
 }
 
 // Pull state change callback for visual feedback
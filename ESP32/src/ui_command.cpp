@@ -0,0 +1,274 @@
+#include "ui_command.h"
+#include "hebrew_tabs.h"
+#include "lv_pull_refresh.h"
+#include "lv_expandable_card.h"
+#include "mpsc_ring.hpp"
+#include "lvgl_task.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <atomic>
+#include <stdlib.h>
+#include <string.h>
+
+static const char* TAG = "UI_CMD";
+
+typedef enum {
+    UI_CMD_SET_TEXT = 0,
+    UI_CMD_PULL_REFRESH_DONE,
+    UI_CMD_ADD_CARD,
+    UI_CMD_CALL,
+} ui_cmd_type_t;
+
+typedef struct {
+    ui_cmd_type_t type;
+    lv_obj_t *target;
+    void *data;                 // Owned copy: text, or a card_block_t
+    ui_command_fn_t fn;
+    void *arg;
+    int64_t posted_us;
+} ui_cmd_t;
+
+// One allocation per card: the card keeps pointers into it until deleted
+typedef struct {
+    lv_card_data_t card;
+    char text[];                // title \0 content \0
+} card_block_t;
+
+// Latest text for one label; whoever exchanges a text out owns it
+typedef struct {
+    std::atomic<lv_obj_t *> target;  // Set once, never released
+    std::atomic<char *> text;
+    std::atomic<int64_t> posted_us;
+} text_slot_t;
+
+static mpsc_ring<ui_cmd_t, UI_CMD_QUEUE_SIZE> queue;
+static std::atomic<uint32_t> queued{0};      // Entries pushed and not yet popped
+static text_slot_t text_slots[UI_CMD_TEXT_SLOTS];
+
+// Producer side, any task
+static std::atomic<uint32_t> posted{0};
+static std::atomic<uint32_t> dropped{0};
+static std::atomic<uint32_t> coalesced{0};
+
+// LVGL task only
+static ui_command_stats_t stats;
+static uint64_t latency_sum_us = 0;
+
+// limit: queue entries this kind of command may fill
+static bool post(ui_cmd_t *cmd, uint32_t limit) {
+    cmd->posted_us = esp_timer_get_time();
+    if (queued.fetch_add(1) >= limit || !queue.push(*cmd)) {
+        queued--;
+        free(cmd->data);
+        dropped++;
+        return false;
+    }
+    posted++;
+    lvgl_task_wake(LVGL_TASK_WAKE_APP);
+    return true;
+}
+
+// The label's slot, claiming a free one if it has none; NULL when all are taken
+static text_slot_t *text_slot(lv_obj_t *label) {
+    for (uint32_t i = 0; i < UI_CMD_TEXT_SLOTS; i++) {
+        if (text_slots[i].target.load() == label) return &text_slots[i];
+    }
+    for (uint32_t i = 0; i < UI_CMD_TEXT_SLOTS; i++) {
+        lv_obj_t *owner = NULL;
+        // On failure owner holds whoever claimed it first, maybe the same label
+        if (text_slots[i].target.compare_exchange_strong(owner, label) || owner == label) {
+            return &text_slots[i];
+        }
+    }
+    return NULL;
+}
+
+bool ui_command_set_text(lv_obj_t *label, const char *text) {
+    char *copy = strdup(text ? text : "");
+    if (!copy) {
+        dropped++;
+        return false;
+    }
+
+    text_slot_t *slot = label ? text_slot(label) : NULL;
+    if (!slot) {
+        ui_cmd_t cmd = {};
+        cmd.type = UI_CMD_SET_TEXT;
+        cmd.target = label;
+        cmd.data = copy;
+        return post(&cmd, UI_CMD_QUEUE_SIZE - UI_CMD_RESERVED);
+    }
+
+    slot->posted_us = esp_timer_get_time();
+    char *old = slot->text.exchange(copy);
+    if (old) {
+        // Not applied yet: the LVGL task only ever sees the newest text
+        free(old);
+        coalesced++;
+    }
+    posted++;
+    lvgl_task_wake(LVGL_TASK_WAKE_APP);
+    return true;
+}
+
+bool ui_command_pull_refresh_done(lv_obj_t *container) {
+    ui_cmd_t cmd = {};
+    cmd.type = UI_CMD_PULL_REFRESH_DONE;
+    cmd.target = container;
+    return post(&cmd, UI_CMD_QUEUE_SIZE);
+}
+
+bool ui_command_add_card(const char *title, const char *content) {
+    size_t title_len = strlen(title);
+    size_t content_len = strlen(content);
+    card_block_t *block = (card_block_t *)malloc(sizeof(card_block_t) + title_len + content_len + 2);
+    if (!block) {
+        dropped++;
+        return false;
+    }
+    memcpy(block->text, title, title_len + 1);
+    memcpy(block->text + title_len + 1, content, content_len + 1);
+    block->card.title = block->text;
+    block->card.content = block->text + title_len + 1;
+
+    ui_cmd_t cmd = {};
+    cmd.type = UI_CMD_ADD_CARD;
+    cmd.data = block;
+    return post(&cmd, UI_CMD_QUEUE_SIZE - UI_CMD_RESERVED);
+}
+
+bool ui_command_call(ui_command_fn_t fn, lv_obj_t *target, void *arg) {
+    ui_cmd_t cmd = {};
+    cmd.type = UI_CMD_CALL;
+    cmd.target = target;
+    cmd.fn = fn;
+    cmd.arg = arg;
+    return post(&cmd, UI_CMD_QUEUE_SIZE);
+}
+
+static void card_delete_cb(lv_event_t *e) {
+    free(lv_event_get_user_data(e));
+}
+
+// Takes ownership of cmd->data
+static void apply(ui_cmd_t *cmd) {
+    if (cmd->target && !lv_obj_is_valid(cmd->target)) {
+        stats.stale++;
+        free(cmd->data);
+        return;
+    }
+
+    switch (cmd->type) {
+        case UI_CMD_SET_TEXT:
+            lv_label_set_text(cmd->target, (const char *)cmd->data);
+            free(cmd->data);
+            break;
+        case UI_CMD_PULL_REFRESH_DONE:
+            lv_pull_refresh_complete(cmd->target);
+            break;
+        case UI_CMD_ADD_CARD: {
+            card_block_t *block = (card_block_t *)cmd->data;
+            lv_obj_t *card = news_tab_add_card(&block->card);
+            if (card) {
+                lv_obj_add_event_cb(card, card_delete_cb, LV_EVENT_DELETE, block);
+            } else {
+                free(block);
+            }
+            break;
+        }
+        case UI_CMD_CALL:
+            cmd->fn(cmd->target, cmd->arg);
+            break;
+    }
+
+    uint32_t latency_us = (uint32_t)(esp_timer_get_time() - cmd->posted_us);
+    latency_sum_us += latency_us;
+    if (latency_us > stats.latency_max_us) stats.latency_max_us = latency_us;
+    stats.applied++;
+}
+
+uint32_t ui_command_drain(void) {
+    ui_cmd_t texts[UI_CMD_TEXT_SLOTS];
+    uint32_t text_count = 0;
+    for (uint32_t i = 0; i < UI_CMD_TEXT_SLOTS; i++) {
+        text_slot_t *slot = &text_slots[i];
+        lv_obj_t *target = slot->target.load();
+        if (!target) break;  // Slots are claimed in order
+        char *text = slot->text.exchange(NULL);
+        if (!text) continue;
+        ui_cmd_t *cmd = &texts[text_count++];
+        *cmd = {};
+        cmd->type = UI_CMD_SET_TEXT;
+        cmd->target = target;
+        cmd->data = text;
+        cmd->posted_us = slot->posted_us;
+    }
+
+    ui_cmd_t batch[UI_CMD_BUDGET];
+    uint32_t count = 0;
+    while (count < UI_CMD_BUDGET && queue.pop(&batch[count])) {
+        queued--;
+        count++;
+    }
+    if (count == 0 && text_count == 0) return 0;
+    if (count == UI_CMD_BUDGET && !queue.empty()) {
+        stats.budget_hits++;
+        // The rest waits for the next drain; make sure there is one soon
+        lvgl_task_wake(LVGL_TASK_WAKE_APP);
+    }
+
+    uint32_t applied = 0;
+    lv_lock();
+    for (uint32_t i = 0; i < text_count; i++) {
+        apply(&texts[i]);
+        applied++;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        ui_cmd_t *cmd = &batch[i];
+        if (cmd->type == UI_CMD_SET_TEXT) {
+            // A newer text for the same label in this batch wins
+            bool replaced = false;
+            for (uint32_t j = i + 1; j < count && !replaced; j++) {
+                replaced = batch[j].type == UI_CMD_SET_TEXT && batch[j].target == cmd->target;
+            }
+            if (replaced) {
+                coalesced++;
+                free(cmd->data);
+                continue;
+            }
+        }
+        apply(cmd);
+        applied++;
+    }
+    lv_unlock();
+
+    ESP_LOGD(TAG, "Applied %lu of %lu commands", (unsigned long)applied, (unsigned long)(text_count + count));
+    return applied;
+}
+
+void ui_command_get_stats(ui_command_stats_t *out) {
+    if (!out) return;
+    *out = stats;
+    out->posted = posted;
+    out->dropped = dropped;
+    out->coalesced = coalesced;
+    out->latency_avg_us = stats.applied ? (uint32_t)(latency_sum_us / stats.applied) : 0;
+}
+
+void ui_command_reset_stats(void) {
+    memset(&stats, 0, sizeof(stats));
+    latency_sum_us = 0;
+    posted = 0;
+    dropped = 0;
+    coalesced = 0;
+}
+
+void ui_command_report_stats(void) {
+    ui_command_stats_t cmds;
+    ui_command_get_stats(&cmds);
+    ESP_LOGI(TAG, "UI CMD - %lu posted, %lu applied, %lu coalesced, %lu dropped, %lu stale, %lu budget hits, latency %lu us avg (max %lu)",
+             (unsigned long)cmds.posted, (unsigned long)cmds.applied, (unsigned long)cmds.coalesced,
+             (unsigned long)cmds.dropped, (unsigned long)cmds.stale, (unsigned long)cmds.budget_hits,
+             (unsigned long)cmds.latency_avg_us, (unsigned long)cmds.latency_max_us);
+    ui_command_reset_stats();
+}
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Print native benchmark summaries side by side.
+
+Usage: bench_compare.py partial.json direct.json [more.json ...]
+
+Each file is the JSON printed by the native benchmark program. The first
+file is the baseline; the other columns also show the change against it.
+"""
+
+import json
+import sys
+
+# (label, path into the JSON document)
+ROWS = [
+    ("render mode", ("render_mode",)),
+    ("flush mode", ("flush_mode",)),
+    ("draw units", ("draw_units",)),
+    ("frames", ("summary", "rendered_frames")),
+    ("fps", ("summary", "frame_rates", "fps")),
+    ("dirty %", ("summary", "frame_rates", "dirty_pct")),
+    ("render_us avg", ("summary", "render_us", "avg")),
+    ("render_us p50", ("summary", "render_us", "p50")),
+    ("render_us p95", ("summary", "render_us", "p95")),
+    ("render_us p99", ("summary", "render_us", "p99")),
+    ("frame_us p50", ("summary", "frame_us", "p50")),
+    ("frame_us p95", ("summary", "frame_us", "p95")),
+    ("frame_us max", ("summary", "frame_us", "max")),
+    ("flush p99", ("summary", "perf", "flush", "p99")),
+    ("handler p99", ("summary", "perf", "timer_handler", "p99")),
+    ("jitter p99", ("summary", "perf", "refresh_jitter", "p99")),
+    ("bus_busy_us", ("summary", "bus_busy_us")),
+    ("pixel bytes", ("summary", "flushed_pixel_bytes")),
+    ("windows", ("summary", "flush_windows")),
+    ("lvgl heap peak", ("summary", "lvgl_heap", "peak")),
+    ("awake %", ("summary", "power", "duty_pct")),
+]
+
+
+def lookup(doc, path):
+    for key in path:
+        if not isinstance(doc, dict) or key not in doc:
+            return None
+        doc = doc[key]
+    return doc
+
+
+def cell(value, base):
+    if value is None:
+        return "-"
+    if isinstance(value, (int, float)) and isinstance(base, (int, float)) and base:
+        return "%s (%+.1f%%)" % (value, (value - base) * 100.0 / base)
+    return str(value)
+
+
+def main(argv):
+    if len(argv) < 3:
+        print(__doc__.strip(), file=sys.stderr)
+        return 1
+
+    docs = []
+    for path in argv[1:]:
+        with open(path) as f:
+            docs.append(json.load(f))
+
+    table = [["metric"] + argv[1:]]
+    for label, path in ROWS:
+        base = lookup(docs[0], path)
+        row = [label, cell(base, None)]
+        row += [cell(lookup(doc, path), base) for doc in docs[1:]]
+        table.append(row)
+
+    widths = [max(len(row[i]) for row in table) for i in range(len(table[0]))]
+    for row in table:
+        print("  ".join(text.ljust(widths[i]) for i, text in enumerate(row)).rstrip())
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))